@@ -0,0 +1,106 @@
+/*  compacthull.cpp
+ *
+ *  hulls stored as 32-bit point indices.
+ *
+ */
+
+
+#include "compacthull.h"
+#include "incremental.h"
+#include <stdio.h>
+#include <vector>
+
+using namespace std;
+
+
+void compact_hull_from_mesh(hull_mesh *mesh, compact_hull *out) {
+
+  //the dead faces are all on the free list, so the live ones are known
+  //before the pass that copies them and counts their vertices
+  int nf = mesh->face.size() / 3;
+  long live = nf - (long)mesh->free.size();
+  vector<unsigned int> face;
+  face.reserve(3 * live);
+  vector<char> used(mesh->vert.size(), 0);
+  int nv = 0;
+  for (int f = 0; f < nf; f++) {
+    if (mesh->face[3*f] == DEAD_FACE) continue;
+    for (int i = 0; i < 3; i++) {
+      int v = mesh->face[3*f+i];
+      face.push_back(mesh->vert[v]);
+      nv += !used[v];
+      used[v] = 1;
+    }
+  }
+  out->face.swap(face);
+  out->nvertices = nv;
+}
+
+
+void compact_hull_from_faces(vector<point3d> &points, vector<triangle3d> &hull,
+                             compact_hull *out) {
+
+  vector<unsigned int> face;
+  face.reserve(3 * hull.size());
+  vector<char> used(points.size(), 0);
+  int nv = 0;
+  point3d *base = points.data();
+  for (size_t f = 0; f < hull.size(); f++) {
+    point3d *c[3] = {hull[f].a, hull[f].b, hull[f].c};
+    for (int i = 0; i < 3; i++) {
+      unsigned int p = c[i] - base;
+      face.push_back(p);
+      nv += !used[p];
+      used[p] = 1;
+    }
+  }
+  out->face.swap(face);
+  out->nvertices = nv;
+}
+
+
+void compact_hull_triangles(vector<point3d> &points, compact_hull *c, vector<triangle3d> &hull) {
+
+  vector<triangle3d> faces;
+  faces.reserve(c->face.size() / 3);
+  for (size_t k = 0; k + 2 < c->face.size(); k += 3) {
+    triangle3d t = {&points[c->face[k]], &points[c->face[k+1]], &points[c->face[k+2]]};
+    faces.push_back(t);
+  }
+  hull.swap(faces);
+}
+
+
+void incremental_compact_hull(vector<point3d> &points, compact_hull *out) {
+
+  vector<int> ids(points.size());
+  for (size_t i = 0; i < points.size(); i++) ids[i] = i;
+  hull_mesh mesh;
+  incremental_hull_mesh(points, ids, &mesh);
+  compact_hull_from_mesh(&mesh, out);
+}
+
+
+void hull_memory_usage(vector<triangle3d> *hull, compact_hull *c, hull_memory *m) {
+
+  m->faces = 0;
+  m->triangle_bytes = m->compact_bytes = m->unused_bytes = 0;
+  if (hull) {
+    m->faces = hull->size();
+    m->triangle_bytes = hull->capacity() * sizeof(triangle3d);
+    m->unused_bytes += (hull->capacity() - hull->size()) * sizeof(triangle3d);
+  }
+  if (c) {
+    m->faces = c->face.size() / 3;
+    m->compact_bytes = c->face.capacity() * sizeof(unsigned int);
+    m->unused_bytes += (c->face.capacity() - c->face.size()) * sizeof(unsigned int);
+  }
+}
+
+
+void print_hull_memory(hull_memory *m) {
+
+  printf("hull memory: %ld faces, %zu bytes as triangles, %zu as 32-bit indices",
+         m->faces, m->triangle_bytes, m->compact_bytes);
+  printf(" (%zu unused)\n", m->unused_bytes);
+}
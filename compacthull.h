@@ -0,0 +1,54 @@
+#ifndef __compacthull_h
+#define __compacthull_h
+
+#include "geom.h"
+#include "hullmesh.h"
+
+#include <stddef.h>
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* a hull as 3 32-bit indices into its points per face: 12 bytes a face
+   instead of the 24 of a triangle3d on a 64-bit machine */
+typedef struct _compact_hull {
+  vector<unsigned int> face;  //oriented like brute_force_hull()
+  int nvertices;              //distinct points used by the faces
+} compact_hull;
+
+/* how much memory a hull takes, counting the capacity of the vectors */
+typedef struct _hull_memory {
+  long faces;
+  size_t triangle_bytes;      //as a vector<triangle3d>
+  size_t compact_bytes;       //as a compact_hull
+  size_t unused_bytes;        //capacity beyond the size, in both
+} hull_memory;
+
+
+/* the live faces of a mesh, without building triangles. the mesh
+   knows how many faces are dead, so the array is allocated once at
+   its final size */
+void compact_hull_from_mesh(hull_mesh *mesh, compact_hull *out);
+
+/* a face list pointing into points, as indices, allocated once at 3
+   per face of the list */
+void compact_hull_from_faces(vector<point3d> &points, vector<triangle3d> &hull,
+                             compact_hull *out);
+
+/* the faces of c as triangles pointing into points, sized exactly */
+void compact_hull_triangles(vector<point3d> &points, compact_hull *c, vector<triangle3d> &hull);
+
+/* the hull of the points by the incremental engine (incremental.h),
+   written straight from its mesh into out */
+void incremental_compact_hull(vector<point3d> &points, compact_hull *out);
+
+
+/* what hull and c take; either may be NULL */
+void hull_memory_usage(vector<triangle3d> *hull, compact_hull *c, hull_memory *m);
+
+void print_hull_memory(hull_memory *m);
+
+#endif
@@ -0,0 +1,284 @@
+/*  dedup.cpp
+ *
+ *  removing repeated points before a hull is computed.
+ *
+ *  the threads insert the keys of their ranges of points in one shared
+ *  open addressing table. a slot is claimed with a compare and swap on
+ *  its key, and it keeps the smallest input index that reached it, so
+ *  which point is kept for each key, and the order of the distinct
+ *  points, do not depend on how the threads ran.
+ *
+ */
+
+
+#include "dedup.h"
+#include <limits.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+//below this many points the threads cost more than they save
+const long PARALLEL_POINTS = 10000;
+
+//bits per axis in a packed key
+const int KEY_BITS = 21;
+
+
+/* what the passes share */
+typedef struct _dedup_pass {
+  vector<point3d> *input;
+  dedup_table *out;
+  int grid;
+  long long lo[3];                     //smallest snapped coordinates
+  vector<long long> bounds;            //lo[3], hi[3] of each thread's range
+  unsigned long long mask;             //table size - 1
+  atomic<unsigned long long> *key;     //packed key + 1, 0 while the slot is free
+  atomic<int> *lowest;                 //smallest input index with the slot's key
+  vector<int> slot;                    //slot of each input point
+  vector<int> id;                      //distinct index of each used slot
+  vector<long> count;                  //distinct points first seen in each thread's range
+} dedup_pass;
+
+typedef void (*dedup_range)(dedup_pass *d, int t, long from, long to);
+
+
+/* v divided by grid, rounded to the nearest integer */
+static long long snap(int v, int grid) {
+  if (grid <= 1) return v;
+  long long a = (long long)v + grid / 2;
+  return (a >= 0) ? a / grid : -((-a + grid - 1) / grid);
+}
+
+/* the point at the snapped coordinates, clamped to the int range */
+static point3d unsnap(long long q[3], int grid) {
+  long long c[3];
+  for (int i = 0; i < 3; i++) {
+    c[i] = (grid > 1) ? q[i] * grid : q[i];
+    c[i] = max((long long)INT_MIN, min((long long)INT_MAX, c[i]));
+  }
+  point3d p = {(int)c[0], (int)c[1], (int)c[2]};
+  return p;
+}
+
+static void snap_point(dedup_pass *d, long i, long long q[3]) {
+  point3d &p = (*d->input)[i];
+  q[0] = snap(p.x, d->grid);
+  q[1] = snap(p.y, d->grid);
+  q[2] = snap(p.z, d->grid);
+}
+
+static unsigned long long pack(dedup_pass *d, long i) {
+  long long q[3];
+  snap_point(d, i, q);
+  return ((unsigned long long)(q[0] - d->lo[0]) << (2 * KEY_BITS)) |
+         ((unsigned long long)(q[1] - d->lo[1]) << KEY_BITS) |
+         (unsigned long long)(q[2] - d->lo[2]);
+}
+
+/* the finalizer of splitmix64 */
+static unsigned long long mix(unsigned long long k) {
+  k = (k ^ (k >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  k = (k ^ (k >> 27)) * 0x94D049BB133111EBULL;
+  return k ^ (k >> 31);
+}
+
+
+/* run fn over [0, n) in nthreads ranges */
+static void run_ranges(dedup_range fn, dedup_pass *d, long n, int nthreads) {
+
+  long chunk = (n + nthreads - 1) / nthreads;
+  if (nthreads == 1) {
+    fn(d, 0, 0, n);
+    return;
+  }
+  vector<thread> workers;
+  for (int t = 0; t < nthreads; t++) {
+    long from = min(n, t * chunk), to = min(n, from + chunk);
+    workers.push_back(thread(fn, d, t, from, to));
+  }
+  for (int t = 0; t < nthreads; t++) workers[t].join();
+}
+
+
+static void bound_range(dedup_pass *d, int t, long from, long to) {
+
+  long long *b = &d->bounds[6*t];
+  for (int i = 0; i < 3; i++) {
+    b[i] = LLONG_MAX;
+    b[3+i] = LLONG_MIN;
+  }
+  for (long i = from; i < to; i++) {
+    long long q[3];
+    snap_point(d, i, q);
+    for (int k = 0; k < 3; k++) {
+      b[k] = min(b[k], q[k]);
+      b[3+k] = max(b[3+k], q[k]);
+    }
+  }
+}
+
+static void clear_range(dedup_pass *d, int t, long from, long to) {
+  for (long s = from; s < to; s++) {
+    d->key[s].store(0);
+    d->lowest[s].store(INT_MAX);
+  }
+}
+
+static void insert_range(dedup_pass *d, int t, long from, long to) {
+
+  for (long i = from; i < to; i++) {
+    unsigned long long k = pack(d, i) + 1;
+    unsigned long long s = mix(k) & d->mask;
+    while (true) {
+      unsigned long long found = d->key[s].load();
+      if (found == 0 && d->key[s].compare_exchange_strong(found, k)) break;
+      if (found == k) break;
+      s = (s + 1) & d->mask;
+    }
+    d->slot[i] = s;
+
+    int low = d->lowest[s].load();
+    while (i < low && !d->lowest[s].compare_exchange_weak(low, (int)i)) {}
+  }
+}
+
+static void count_range(dedup_pass *d, int t, long from, long to) {
+  long c = 0;
+  for (long i = from; i < to; i++) c += (d->lowest[d->slot[i]].load() == i);
+  d->count[t] = c;
+}
+
+static void number_range(dedup_pass *d, int t, long from, long to) {
+
+  long u = 0;
+  for (int k = 0; k < t; k++) u += d->count[k];
+  for (long i = from; i < to; i++) {
+    if (d->lowest[d->slot[i]].load() != i) continue;
+    long long q[3];
+    snap_point(d, i, q);
+    d->id[d->slot[i]] = u;
+    d->out->points[u] = unsnap(q, d->grid);
+    d->out->first[u] = i;
+    u++;
+  }
+}
+
+static void remap_range(dedup_pass *d, int t, long from, long to) {
+  for (long i = from; i < to; i++) d->out->remap[i] = d->id[d->slot[i]];
+}
+
+
+/* a snapped point and where it came from */
+typedef struct _snapped_point {
+  long long q[3];
+  int i;
+} snapped_point;
+
+static bool snapped_less(const snapped_point &a, const snapped_point &b) {
+  for (int k = 0; k < 3; k++) {
+    if (a.q[k] != b.q[k]) return a.q[k] < b.q[k];
+  }
+  return a.i < b.i;
+}
+
+/* the same result by sorting, for coordinates too far apart to pack */
+static long dedup_sorted(dedup_pass *d, long n) {
+
+  vector<snapped_point> order(n);
+  for (long i = 0; i < n; i++) {
+    snap_point(d, i, order[i].q);
+    order[i].i = i;
+  }
+  sort(order.begin(), order.end(), snapped_less);
+
+  //each point's lowest twin, then the distinct points in input order
+  vector<int> lowest(n), id(n);
+  vector<long long> q(3 * n);
+  for (long k = 0; k < n; k++) {
+    snapped_point &s = order[k];
+    bool twin = k > 0 && s.q[0] == order[k-1].q[0] && s.q[1] == order[k-1].q[1] &&
+                s.q[2] == order[k-1].q[2];
+    lowest[s.i] = twin ? lowest[order[k-1].i] : s.i;
+    for (int c = 0; c < 3; c++) q[3*s.i+c] = s.q[c];
+  }
+  dedup_table *out = d->out;
+  for (long i = 0; i < n; i++) {
+    if (lowest[i] == i) {
+      id[i] = out->points.size();
+      out->points.push_back(unsnap(&q[3*i], d->grid));
+      out->first.push_back(i);
+    }
+    out->remap[i] = id[lowest[i]];
+  }
+  return out->points.size();
+}
+
+
+long dedup_points(vector<point3d> &points, int grid, dedup_table *out, int nthreads) {
+
+  long n = points.size();
+  dedup_pass d;
+  d.input = &points;
+  d.out = out;
+  d.grid = grid;
+  out->points.clear();
+  out->first.clear();
+  out->remap.resize(n);
+  if (n == 0) return 0;
+
+  if (nthreads <= 0) nthreads = thread::hardware_concurrency();
+  if (nthreads <= 0 || n < PARALLEL_POINTS) nthreads = 1;
+
+  //the snapped bounding box decides whether the keys fit in 64 bits
+  d.bounds.resize(6 * nthreads);
+  run_ranges(bound_range, &d, n, nthreads);
+  long long hi[3];
+  for (int k = 0; k < 3; k++) {
+    d.lo[k] = LLONG_MAX;
+    hi[k] = LLONG_MIN;
+    for (int t = 0; t < nthreads; t++) {
+      d.lo[k] = min(d.lo[k], d.bounds[6*t+k]);
+      hi[k] = max(hi[k], d.bounds[6*t+3+k]);
+    }
+    if (hi[k] - d.lo[k] >= (1LL << KEY_BITS)) return dedup_sorted(&d, n);
+  }
+
+  //a table at most half full
+  unsigned long long size = 16;
+  while (size < 2 * (unsigned long long)n) size *= 2;
+  d.mask = size - 1;
+  d.key = new atomic<unsigned long long>[size];
+  d.lowest = new atomic<int>[size];
+  d.slot.resize(n);
+  d.id.resize(size);
+  d.count.resize(nthreads);
+
+  run_ranges(clear_range, &d, size, nthreads);
+  run_ranges(insert_range, &d, n, nthreads);
+  run_ranges(count_range, &d, n, nthreads);
+  long m = 0;
+  for (int t = 0; t < nthreads; t++) m += d.count[t];
+  out->points.resize(m);
+  out->first.resize(m);
+  run_ranges(number_range, &d, n, nthreads);
+  run_ranges(remap_range, &d, n, nthreads);
+
+  delete [] d.key;
+  delete [] d.lowest;
+  return m;
+}
+
+
+void dedup_faces(dedup_table *d, vector<point3d> &points, vector<triangle3d> &faces) {
+
+  point3d *base = d->points.data();
+  for (size_t f = 0; f < faces.size(); f++) {
+    faces[f].a = &points[d->first[faces[f].a - base]];
+    faces[f].b = &points[d->first[faces[f].b - base]];
+    faces[f].c = &points[d->first[faces[f].c - base]];
+  }
+}
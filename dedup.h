@@ -0,0 +1,40 @@
+#ifndef __dedup_h
+#define __dedup_h
+
+#include "geom.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* the distinct points of an input, and how to get back to the input */
+typedef struct _dedup_table {
+  vector<point3d> points;  //the distinct points, in the order they first appear
+  vector<int> remap;       //remap[i]: the index in points of input point i
+  vector<int> first;       //first[u]: the first input point that became points[u]
+} dedup_table;
+
+
+/* fill out with the distinct points of points. with grid > 1 every
+   coordinate is first snapped to the nearest multiple of grid, so
+   points closer than about grid become one. the coordinates are packed
+   into 64-bit keys and inserted in a lock-free open addressing table by
+   nthreads threads (0 means one per core); when they do not fit in 21
+   bits per axis the points are sorted instead. the result does not
+   depend on the number of threads. returns the number of distinct
+   points */
+long dedup_points(vector<point3d> &points, int grid, dedup_table *out, int nthreads);
+
+/* make the faces of a hull of out->points point to the input points
+   they came from instead (first[]).
+
+   NOTE: with grid > 1 these are the unsnapped points, so the faces no
+   longer form a convex hull: a corner can move by up to grid/2 along
+   each axis, which can make edges reflex and leave input points
+   outside. use the snapped out->points where convexity matters */
+void dedup_faces(dedup_table *d, vector<point3d> &points, vector<triangle3d> &faces);
+
+#endif
@@ -0,0 +1,173 @@
+/*  delaunay.cpp
+ *
+ *  Delaunay triangulations and Voronoi diagrams in the plane, from the
+ *  3d hull of the points lifted onto a paraboloid.
+ *
+ *  a circle through a, b, c lifts to the plane through their lifted
+ *  points, and a point is inside the circle exactly when its lift is
+ *  below that plane. so abc is a Delaunay triangle exactly when no
+ *  lifted point is below the plane of its lift: when it is a face of
+ *  the lower hull.
+ *
+ */
+
+
+#include "delaunay.h"
+#include "dedup.h"
+#include "incremental.h"
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+
+long long orient2d(point2d a, point2d b, point2d c) {
+  return ((long long)b.x - a.x) * ((long long)c.y - a.y) -
+         ((long long)b.y - a.y) * ((long long)c.x - a.x);
+}
+
+
+/* a point and where it is in the input */
+typedef struct _site {
+  point2d p;
+  int id;
+} site;
+
+static bool site_less(const site &a, const site &b) {
+  return a.p.x < b.p.x || (a.p.x == b.p.x && a.p.y < b.p.y);
+}
+
+/* the ids of the vertices of the convex hull of the distinct sites s,
+   counterclockwise and without collinear ones (monotone chain) */
+static void convex_polygon(vector<site> &s, vector<int> &h) {
+
+  sort(s.begin(), s.end(), site_less);
+  int n = s.size(), k = 0;
+  vector<site> c(2 * n);
+  for (int i = 0; i < n; i++) {
+    while (k >= 2 && orient2d(c[k-2].p, c[k-1].p, s[i].p) <= 0) k--;
+    c[k++] = s[i];
+  }
+  for (int i = n - 2, low = k + 1; i >= 0; i--) {
+    while (k >= low && orient2d(c[k-2].p, c[k-1].p, s[i].p) <= 0) k--;
+    c[k++] = s[i];
+  }
+  h.clear();
+  for (int i = 0; i < k - 1; i++) h.push_back(c[i].id);
+}
+
+
+int delaunay_triangulation(vector<point2d> &points, vector<int> &tri) {
+
+  tri.clear();
+
+  //the distinct points, in the plane z = 0
+  vector<point3d> flat(points.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    point3d p = {points[i].x, points[i].y, 0};
+    flat[i] = p;
+  }
+  dedup_table d;
+  long m = dedup_points(flat, 1, &d, 0);
+  if (m < 3) return 0;
+
+  //centered, so that x^2 + y^2 fits in an int
+  long long lo[2] = {d.points[0].x, d.points[0].y}, hi[2] = {lo[0], lo[1]};
+  for (long i = 1; i < m; i++) {
+    lo[0] = min(lo[0], (long long)d.points[i].x);
+    hi[0] = max(hi[0], (long long)d.points[i].x);
+    lo[1] = min(lo[1], (long long)d.points[i].y);
+    hi[1] = max(hi[1], (long long)d.points[i].y);
+  }
+  long long center[2] = {lo[0] + (hi[0] - lo[0]) / 2, lo[1] + (hi[1] - lo[1]) / 2};
+  for (int k = 0; k < 2; k++) {
+    if (hi[k] - center[k] > LIFT_MAX || center[k] - lo[k] > LIFT_MAX) return -1;
+  }
+
+  vector<point3d> lifted(m);
+  vector<int> ids(m);
+  for (long i = 0; i < m; i++) {
+    int x = d.points[i].x - center[0], y = d.points[i].y - center[1];
+    point3d p = {x, y, x*x + y*y};
+    lifted[i] = p;
+    ids[i] = i;
+  }
+  hull_mesh mesh;
+  incremental_hull_mesh(lifted, ids, &mesh);
+
+  //the faces with the inside of the hull above them
+  for (size_t f = 0; f < mesh.face.size() / 3; f++) {
+    if (mesh.face[3*f] == DEAD_FACE) continue;
+    int v[3];
+    for (int i = 0; i < 3; i++) v[i] = mesh.vert[mesh.face[3*f+i]];
+    point3d &a = lifted[v[0]], above = {a.x, a.y, a.z + 1};
+    if (volume_sign(a, lifted[v[1]], lifted[v[2]], above) >= 0) continue;
+
+    int t[3] = {d.first[v[0]], d.first[v[1]], d.first[v[2]]};
+    if (orient2d(points[t[0]], points[t[1]], points[t[2]]) < 0) swap(t[1], t[2]);
+    tri.insert(tri.end(), t, t + 3);
+  }
+
+  //no faces: the lifted points are on one plane, so the points are on
+  //one line, with no triangles, or on one circle, where every
+  //triangulation of their polygon is Delaunay
+  if (tri.empty()) {
+    vector<site> s(m);
+    for (long i = 0; i < m; i++) {
+      s[i].p = points[d.first[i]];
+      s[i].id = d.first[i];
+    }
+    vector<int> h;
+    convex_polygon(s, h);
+    for (size_t i = 1; i + 1 < h.size(); i++) {
+      int t[3] = {h[0], h[i], h[i+1]};
+      tri.insert(tri.end(), t, t + 3);
+    }
+  }
+  return tri.size() / 3;
+}
+
+
+void voronoi_from_delaunay(vector<point2d> &points, vector<int> &tri, voronoi *out) {
+
+  int nt = tri.size() / 3;
+  out->vertex.resize(2 * nt);
+  out->edge.clear();
+
+  //the circumcenters
+  for (int t = 0; t < nt; t++) {
+    point2d &a = points[tri[3*t]], &b = points[tri[3*t+1]], &c = points[tri[3*t+2]];
+    double bx = (double)b.x - a.x, by = (double)b.y - a.y;
+    double cx = (double)c.x - a.x, cy = (double)c.y - a.y;
+    double det = 2 * (bx * cy - by * cx), b2 = bx*bx + by*by, c2 = cx*cx + cy*cy;
+    out->vertex[2*t] = a.x + (cy * b2 - by * c2) / det;
+    out->vertex[2*t+1] = a.y + (bx * c2 - cx * b2) / det;
+  }
+
+  //every directed edge and its triangle, to find the triangle across
+  vector<pair<pair<int, int>, int> > edges;
+  for (int t = 0; t < nt; t++) {
+    for (int i = 0; i < 3; i++) {
+      edges.push_back(make_pair(make_pair(tri[3*t+i], tri[3*t+(i+1)%3]), t));
+    }
+  }
+  sort(edges.begin(), edges.end());
+
+  for (size_t k = 0; k < edges.size(); k++) {
+    int a = edges[k].first.first, b = edges[k].first.second, t = edges[k].second;
+    pair<pair<int, int>, int> key = make_pair(make_pair(b, a), -1);
+    vector<pair<pair<int, int>, int> >::iterator across =
+      lower_bound(edges.begin(), edges.end(), key);
+    voronoi_edge e = {{a, b}, {t, -1}, {0, 0}};
+    if (across != edges.end() && across->first == key.first) {
+      //once per pair of triangles
+      if (across->second < t) continue;
+      e.vertex[1] = across->second;
+    } else {
+      //a hull edge: the inside is to the left of ab
+      e.dir[0] = (double)points[b].y - points[a].y;
+      e.dir[1] = (double)points[a].x - points[b].x;
+    }
+    out->edge.push_back(e);
+  }
+}
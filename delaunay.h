@@ -0,0 +1,55 @@
+#ifndef __delaunay_h
+#define __delaunay_h
+
+#include "geom.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+typedef struct _point2d {
+  int x, y;
+} point2d;
+
+/* an edge of a Voronoi diagram: the part of the bisector of two sites
+   between the circumcenters of the two Delaunay triangles on their
+   edge, or the ray from the one triangle of a convex hull edge */
+typedef struct _voronoi_edge {
+  int site[2];       //the input points it separates
+  int vertex[2];     //its ends, as Delaunay triangles; vertex[1] is -1 for a ray
+  double dir[2];     //for a ray, its direction, away from the triangulation
+} voronoi_edge;
+
+typedef struct _voronoi {
+  vector<double> vertex;       //x, y of the circumcenter of every Delaunay triangle
+  vector<voronoi_edge> edge;   //one per Delaunay edge
+} voronoi;
+
+
+//lifted points must fit in a point3d: the points are centered first,
+//and then their coordinates may be at most this far from the center
+#define LIFT_MAX 32767
+
+/* the Delaunay triangulation of the points, into tri: 3 indices into
+   points per triangle, counterclockwise. the distinct points are lifted
+   onto the paraboloid z = x^2 + y^2 and the faces of their 3d hull
+   (incremental.h) that face down are the triangles; the predicate of
+   the hull is exact, so this is the exact triangulation, with an
+   arbitrary choice among cocircular points. when all the points are on
+   one circle the lifted points have no 3d hull, and their polygon is
+   triangulated as a fan instead. returns the number of
+   triangles, or -1 if the points span more than 2 LIFT_MAX along x or
+   y */
+int delaunay_triangulation(vector<point2d> &points, vector<int> &tri);
+
+/* the Voronoi diagram of the points, as the dual of their Delaunay
+   triangulation tri */
+void voronoi_from_delaunay(vector<point2d> &points, vector<int> &tri, voronoi *out);
+
+/* twice the signed area of abc: positive if abc is counterclockwise */
+long long orient2d(point2d a, point2d b, point2d c);
+
+#endif
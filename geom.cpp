@@ -9,6 +9,7 @@
 
 
 #include "geom.h"
+#include "dedup.h"
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -24,23 +25,48 @@ and point d. formula given in Computational Geometry textbook.
 */
 int signed_volume(point3d a, point3d b, point3d c, point3d d) {
 
-  return  (((-(a.z - d.z)*(b.y - d.y)*(c.x - d.x) + (a.y - d.y)*(b.z - d.z)*(c.x - d.x) +
+  return  (((-(a.z - d.z)*(b.y - d.y)*(c.x - d.x) + (a.y - d.y)*(b.z - d.z)*(c.x - d.x) +
   (a.z - d.z)*(b.x - d.x)*(c.y - d.y) - (a.x - d.x)*(b.z - d.z)*(c.y - d.y) -
   (a.y - d.y)*(b.x - d.x)*(c.z - d.z) + (a.x - d.x)*(b.y - d.y)*(c.z - d.z))) / 6);
 
 }
 
+/* returns the sign (-1, 0 or 1) of the signed volume of abcd. the
+determinant is evaluated with 128-bit integers, so unlike
+signed_volume() it neither overflows on large coordinates nor rounds
+small volumes to 0.
+*/
+int volume_sign(point3d a, point3d b, point3d c, point3d d) {
+
+  __int128 ax = (long long)a.x - d.x, ay = (long long)a.y - d.y, az = (long long)a.z - d.z;
+  __int128 bx = (long long)b.x - d.x, by = (long long)b.y - d.y, bz = (long long)b.z - d.z;
+  __int128 cx = (long long)c.x - d.x, cy = (long long)c.y - d.y, cz = (long long)c.z - d.z;
+
+  __int128 det = ax * (by * cz - bz * cy) - ay * (bx * cz - bz * cx) + az * (bx * cy - by * cx);
+
+  return (det > 0) - (det < 0);
+}
+
 /* return 1 if p,q,r, t on same plane, and 0 otherwise */
 int coplanar(point3d p, point3d q, point3d r, point3d t) {
 
-  return signed_volume(p,q,r,t) == 0;
+  return volume_sign(p,q,r,t) == 0;
 }
 
 
-/* return 1 if d is  strictly left of abc; 0 otherwise */
+/* return 1 if d is  strictly left of abc; 0 otherwise */
 int left(point3d a, point3d b, point3d c, point3d d) {
 
-  return signed_volume(a,b,c,d) < 0;
+  return volume_sign(a,b,c,d) < 0;
+}
+
+/* return 1 if a,b,c are on a line (or not all distinct); 0 otherwise */
+int on_line(point3d a, point3d b, point3d c) {
+
+  __int128 ux = (long long)b.x - a.x, uy = (long long)b.y - a.y, uz = (long long)b.z - a.z;
+  __int128 vx = (long long)c.x - a.x, vy = (long long)c.y - a.y, vz = (long long)c.z - a.z;
+
+  return (uy*vz - uz*vy) == 0 && (uz*vx - ux*vz) == 0 && (ux*vy - uy*vx) == 0;
 }
 
 /* return 1 if the two points are equal; 0 otherwise */
@@ -56,33 +82,38 @@ vector<triangle3d> brute_force_hull(vector<point3d> &points) {
 
   bool extreme = true;
 
-  if (points.size() < 3) {
+  // the loops below assume distinct points
+  dedup_table d;
+  dedup_points(points, 1, &d, 1);
+  vector<point3d> &u = d.points;
+
+  if (u.size() < 3) {
     return result;
   }
 
-  if (points.size() == 3) {
-    triangle3d face = {.a = &points[0], .b = &points[1],.c = &points[2]};
+  if (u.size() == 3) {
+    triangle3d face = {.a = &u[0], .b = &u[1],.c = &u[2]};
     result.push_back(face);
+    dedup_faces(&d, points, result);
     return result;
   }
 
-  // loop through all triplets
-  for (int i = 0; i < points.size(); ++i) {
-    for (int j = 0; j < points.size(); ++j) {
-      for (int k = 0; k < points.size(); ++k) {
-        if (isEqual(points[i], points[j]) || isEqual(points[i], points[k]) || isEqual(points[j], points[k])){
+  // loop through all triplets. i is the smallest index of the face so
+  // that each face is reported once and not once per rotation of ijk
+  for (size_t i = 0; i < u.size(); ++i) {
+    for (size_t j = i+1; j < u.size(); ++j) {
+      for (size_t k = i+1; k < u.size(); ++k) {
+        if (k == j){
           continue;
         } else {
           // for each pair pi, pj, pk
           extreme = true;
 
           // now check if plane defined by pi, pj, pk is extreme
-          for (int p = 0; p < points.size(); ++p) {
+          for (size_t p = 0; p < u.size(); ++p) {
 
-            if (!isEqual(points[p], points[i]) &&
-                !isEqual(points[p], points[j]) &&
-                !isEqual(points[p], points[k]) &&
-                !left(points[i], points[j], points[k], points[p])) {
+            if (p != i && p != j && p != k &&
+                !left(u[i], u[j], u[k], u[p])) {
               extreme = false;
               break;
             }
@@ -90,7 +121,7 @@ vector<triangle3d> brute_force_hull(vector<point3d> &points) {
           }
           if (extreme == true) {
             // create a face and add this face to the hull
-            triangle3d face = {.a = &points[i], .b = &points[j],.c = &points[k]};
+            triangle3d face = {.a = &u[i], .b = &u[j],.c = &u[k]};
             result.push_back(face);
           }
         }
@@ -98,5 +129,7 @@ vector<triangle3d> brute_force_hull(vector<point3d> &points) {
       }
     }
   }
+  // point the faces back into the input
+  dedup_faces(&d, points, result);
   return result;
 }
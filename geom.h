@@ -24,17 +24,25 @@ typedef struct _triangle3d {
  */
 int signed_volume(point3d a, point3d b, point3d c, point3d d);
 
+/* returns the sign (-1, 0, 1) of signed_volume(a,b,c,d), computed
+   exactly for any int coordinates */
+int volume_sign(point3d a, point3d b, point3d c, point3d d);
+
 int isEqual(point3d a, point3d b);
 
 /* return 1 if p,q,r, t on same plane, and 0 otherwise */
 int collinear(point3d p, point3d q, point3d r, point3d t);
 
+/* return 1 if a,b,c are on a line (or not all distinct); 0 otherwise */
+int on_line(point3d a, point3d b, point3d c);
+
 
 /* return 1 if d is  strictly left of abc; 0 otherwise */
 int left(point3d a, point3d b, point3d c, point3d d);
 
 
-/* compute and return the convex hull of the points */
+/* compute and return the convex hull of the points, in O(n^4).
+   repeated points are removed first (dedup.h) */
 vector<triangle3d> brute_force_hull(vector<point3d> &points);
 
 //vector<triangle3d> findTriplets(vector<point3d> points);
@@ -0,0 +1,336 @@
+/*  giftwrap.cpp
+ *
+ *  output sensitive convex hull by gift wrapping.
+ *
+ *  the first face is found from the lexicographically smallest point,
+ *  which is always a hull vertex. every other face is found from an edge
+ *  of a face that is already known: the plane through the edge is
+ *  rotated until no point is outside of it. all the points on that
+ *  plane form one facet, whose 2d hull is triangulated as a fan, and
+ *  whose boundary edges are wrapped in turn.
+ *
+ *  the plane tests are done in floating point with an error bound, and
+ *  only the close calls go to volume_sign().
+ *
+ */
+
+
+#include "giftwrap.h"
+#include "incremental.h"
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+//below this many points the prefilter runs in one thread
+const int PARALLEL_POINTS = 20000;
+
+
+/* the plane through a, b, c in floating point, to filter side() */
+typedef struct _wrap_plane {
+  point3d a, b, c;
+  double nx, ny, nz;    //inward normal (b-a)x(c-a)
+  double err;           //bound on the rounding error of side()
+} wrap_plane;
+
+static wrap_plane make_plane(point3d a, point3d b, point3d c) {
+
+  wrap_plane w;
+  w.a = a;
+  w.b = b;
+  w.c = c;
+  double ux = (double)b.x - a.x, uy = (double)b.y - a.y, uz = (double)b.z - a.z;
+  double vx = (double)c.x - a.x, vy = (double)c.y - a.y, vz = (double)c.z - a.z;
+  w.nx = uy*vz - uz*vy;
+  w.ny = uz*vx - ux*vz;
+  w.nz = ux*vy - uy*vx;
+  w.err = 64 * DBL_EPSILON * (fabs(uy*vz) + fabs(uz*vy) + fabs(uz*vx) + fabs(ux*vz) +
+                              fabs(ux*vy) + fabs(uy*vx));
+  return w;
+}
+
+/* volume_sign(a, b, c, p): 1 if p is outside the plane, -1 if inside */
+static int side(const wrap_plane &w, point3d p) {
+
+  double dx = (double)p.x - w.a.x, dy = (double)p.y - w.a.y, dz = (double)p.z - w.a.z;
+  double s = w.nx*dx + w.ny*dy + w.nz*dz;
+  double bound = w.err * (fabs(dx) + fabs(dy) + fabs(dz));
+
+  if (s > bound) return -1;
+  if (s < -bound) return 1;
+  return volume_sign(w.a, w.b, w.c, p);
+}
+
+
+/* ****************************** */
+/* Akl-Toussaint: drop the points strictly inside the hull of the
+   extreme points in the 26 directions (+-1, 0)^3 */
+
+//one of each pair of opposite directions
+static const double DIRECTIONS[13][3] = {
+  {1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 1, 0}, {1, -1, 0}, {1, 0, 1}, {1, 0, -1},
+  {0, 1, 1}, {0, 1, -1}, {1, 1, 1}, {1, 1, -1}, {1, -1, 1}, {1, -1, -1}
+};
+
+/* the points strictly inside all the planes are dropped */
+static void inside_extremes(vector<point3d> *points, vector<wrap_plane> *planes,
+                            size_t lo, size_t hi, vector<char> *keep) {
+
+  for (size_t i = lo; i < hi; i++) {
+    size_t f = 0;
+    while (f < planes->size() && side((*planes)[f], (*points)[i]) < 0) f++;
+    (*keep)[i] = (f < planes->size());
+  }
+}
+
+void extreme_points(vector<point3d> &points, vector<int> &ext) {
+
+  int n = points.size();
+  int best[26];
+  double bestd[26];
+  for (int d = 0; d < 13; d++) {
+    best[d] = best[d+13] = 0;
+    bestd[d] = bestd[d+13] = -DBL_MAX;
+  }
+  for (int i = 0; i < n; i++) {
+    double x = points[i].x, y = points[i].y, z = points[i].z;
+    for (int d = 0; d < 13; d++) {
+      double v = DIRECTIONS[d][0]*x + DIRECTIONS[d][1]*y + DIRECTIONS[d][2]*z;
+      if (v > bestd[d]) {
+        bestd[d] = v;
+        best[d] = i;
+      }
+      if (-v > bestd[d+13]) {
+        bestd[d+13] = -v;
+        best[d+13] = i;
+      }
+    }
+  }
+  ext.assign(best, best + 26);
+  sort(ext.begin(), ext.end());
+  ext.erase(unique(ext.begin(), ext.end()), ext.end());
+}
+
+static void prefilter(vector<point3d> &points, vector<int> &ids, int nthreads) {
+
+  int n = points.size();
+  vector<int> ext;
+  extreme_points(points, ext);
+
+  //their hull; if it is flat nothing is dropped
+  hull_mesh mesh;
+  incremental_hull_mesh(points, ext, &mesh);
+  vector<wrap_plane> planes;
+  for (size_t f = 0; f < mesh.face.size() / 3; f++) {
+    if (mesh.face[3*f] == DEAD_FACE) continue;
+    planes.push_back(make_plane(points[mesh.vert[mesh.face[3*f]]], points[mesh.vert[mesh.face[3*f+1]]],
+                                points[mesh.vert[mesh.face[3*f+2]]]));
+  }
+
+  vector<char> keep(n, 1);
+  if (planes.size() > 0) {
+    if (nthreads <= 0) nthreads = thread::hardware_concurrency();
+    if (nthreads <= 0 || n < PARALLEL_POINTS) nthreads = 1;
+    size_t chunk = (n + nthreads - 1) / nthreads;
+    if (nthreads == 1) {
+      inside_extremes(&points, &planes, 0, n, &keep);
+    } else {
+      vector<thread> workers;
+      for (int t = 0; t < nthreads; t++) {
+        size_t from = min((size_t)n, t * chunk), to = min((size_t)n, from + chunk);
+        workers.push_back(thread(inside_extremes, &points, &planes, from, to, &keep));
+      }
+      for (int t = 0; t < nthreads; t++) workers[t].join();
+    }
+  }
+
+  ids.clear();
+  for (int i = 0; i < n; i++) {
+    if (keep[i]) ids.push_back(i);
+  }
+}
+
+
+/* ****************************** */
+/* the wrapping itself, on the points left by the prefilter */
+
+typedef struct _wrapper {
+  vector<point3d> *points;
+  vector<int> ids;                 //the candidates
+  vector<triangle3d> hull;
+  set<pair<int, int> > done;       //directed boundary edges of the facets found
+  vector<pair<int, int> > todo;    //boundary edges whose other facet is not known yet
+} wrapper;
+
+
+/* a point c such that no candidate is outside the plane a, b, c. all
+   the candidates must be on one side of some plane through a and b */
+static int pivot(wrapper *w, point3d a, point3d b) {
+
+  vector<point3d> &points = *w->points;
+  size_t k = 0;
+  while (k < w->ids.size() && on_line(a, b, points[w->ids[k]])) k++;
+  if (k == w->ids.size()) return -1;
+
+  int c = w->ids[k];
+  wrap_plane plane = make_plane(a, b, points[c]);
+  for (k++; k < w->ids.size(); k++) {
+    int p = w->ids[k];
+    if (side(plane, points[p]) > 0) {
+      c = p;
+      plane = make_plane(a, b, points[c]);
+    }
+  }
+  return c;
+}
+
+
+/* exact orientation of p, q, r projected on the axes (k+1, k+2) mod 3 */
+static int orient_proj(point3d p, point3d q, point3d r, int k) {
+
+  long long pc[3] = {p.x, p.y, p.z}, qc[3] = {q.x, q.y, q.z}, rc[3] = {r.x, r.y, r.z};
+  int i = (k + 1) % 3, j = (k + 2) % 3;
+  __int128 det = (__int128)(qc[i] - pc[i]) * (rc[j] - pc[j]) - (__int128)(qc[j] - pc[j]) * (rc[i] - pc[i]);
+  return (det > 0) - (det < 0);
+}
+
+/* the points on the plane a, b, c, sorted on the projected axes and
+   then by index, so that the first of equal points is kept */
+typedef struct _proj_less {
+  vector<point3d> *points;
+  int k;
+  bool operator()(int p, int q) const {
+    point3d &a = (*points)[p], &b = (*points)[q];
+    int ac[3] = {a.x, a.y, a.z}, bc[3] = {b.x, b.y, b.z};
+    int i = (k + 1) % 3, j = (k + 2) % 3;
+    if (ac[i] != bc[i]) return ac[i] < bc[i];
+    if (ac[j] != bc[j]) return ac[j] < bc[j];
+    return p < q;
+  }
+} proj_less;
+
+
+/* the candidates on the plane a, b, c, as their 2d hull (strict, with
+   the same orientation as a, b, c) */
+static void facet(wrapper *w, point3d a, point3d b, point3d c, vector<int> &poly) {
+
+  vector<point3d> &points = *w->points;
+  wrap_plane plane = make_plane(a, b, c);
+  vector<int> on;
+  for (size_t k = 0; k < w->ids.size(); k++) {
+    if (side(plane, points[w->ids[k]]) == 0) on.push_back(w->ids[k]);
+  }
+
+  //drop an axis the plane is not parallel to; the predicates are
+  //exact, so any of them will do. the sign of the projected a, b, c
+  //tells whether the projection keeps the orientation
+  int k = 0, sign = 0;
+  while ((sign = orient_proj(a, b, c, k)) == 0) k++;
+
+  proj_less less = {w->points, k};
+  sort(on.begin(), on.end(), less);
+  size_t m = 0;
+  for (size_t t = 0; t < on.size(); t++) {
+    if (m > 0 && isEqual(points[on[m-1]], points[on[t]])) continue;
+    on[m++] = on[t];
+  }
+  on.resize(m);
+
+  //monotone chain, counterclockwise in the projection
+  poly.assign(2 * m, 0);
+  size_t h = 0;
+  for (size_t t = 0; t < m; t++) {
+    while (h >= 2 && orient_proj(points[poly[h-2]], points[poly[h-1]], points[on[t]], k) <= 0) h--;
+    poly[h++] = on[t];
+  }
+  for (size_t t = m - 1, lower = h + 1; t-- > 0; ) {
+    while (h >= lower && orient_proj(points[poly[h-2]], points[poly[h-1]], points[on[t]], k) <= 0) h--;
+    poly[h++] = on[t];
+  }
+  poly.resize(h - 1);
+  if (sign < 0) reverse(poly.begin(), poly.end());
+}
+
+
+/* find the facet that has the edge a->b, triangulate it and queue its
+   other boundary edges */
+static void wrap_edge(wrapper *w, int a, int b) {
+
+  vector<point3d> &points = *w->points;
+  int c = pivot(w, points[a], points[b]);
+  vector<int> poly;
+  facet(w, points[a], points[b], points[c], poly);
+
+  for (size_t t = 0; t < poly.size(); t++) {
+    int u = poly[t], v = poly[(t + 1) % poly.size()];
+    w->done.insert(make_pair(u, v));
+    w->todo.push_back(make_pair(u, v));
+  }
+  for (size_t t = 1; t + 1 < poly.size(); t++) {
+    triangle3d f = {&points[poly[0]], &points[poly[t]], &points[poly[t+1]]};
+    w->hull.push_back(f);
+  }
+}
+
+
+vector<triangle3d> giftwrap_hull(vector<point3d> &points, int nthreads) {
+
+  wrapper w;
+  w.points = &points;
+  if (points.size() < 4) return w.hull;
+  prefilter(points, w.ids, nthreads);
+
+  //no hull if the points are on a plane or a line, or all equal
+  size_t k[4] = {0, 0, 0, 0}, m = w.ids.size();
+  point3d *p = &points[0];
+  int *id = &w.ids[0];
+  while (k[1] < m && isEqual(p[id[0]], p[id[k[1]]])) k[1]++;
+  if (k[1] >= m) return w.hull;
+  while (k[2] < m && on_line(p[id[0]], p[id[k[1]]], p[id[k[2]]])) k[2]++;
+  if (k[2] >= m) return w.hull;
+  while (k[3] < m && volume_sign(p[id[0]], p[id[k[1]]], p[id[k[2]]], p[id[k[3]]]) == 0) k[3]++;
+  if (k[3] >= m) return w.hull;
+
+  //the smallest point, and the line through it parallel to z. all the
+  //points are on one side of the plane x = x0, and the ones on it are
+  //on one side of the line
+  int p0 = w.ids[0];
+  for (size_t k = 1; k < w.ids.size(); k++) {
+    point3d &p = points[w.ids[k]], &q = points[p0];
+    if (p.x < q.x || (p.x == q.x && (p.y < q.y || (p.y == q.y && p.z < q.z)))) p0 = w.ids[k];
+  }
+  point3d q = points[p0];
+  q.z += (q.z < INT_MAX) ? 1 : -1;
+  int c = pivot(&w, points[p0], q);
+
+  //on the supporting plane p0, q, c the neighbour of p0 on the 2d hull
+  //makes a hull edge with it
+  vector<int> poly;
+  facet(&w, points[p0], q, points[c], poly);
+  size_t t = 0;
+  while (poly[t] != p0) t++;
+  int p1 = poly[(t + 1) % poly.size()];
+
+  //then the facet on that edge, and the rest from there
+  wrap_edge(&w, p1, p0);
+
+  while (w.todo.size() > 0) {
+    pair<int, int> e = w.todo.back();
+    w.todo.pop_back();
+    if (w.done.count(make_pair(e.second, e.first))) continue;
+    wrap_edge(&w, e.second, e.first);
+  }
+  return w.hull;
+}
+
+
+vector<triangle3d> giftwrap_hull(vector<point3d> &points) {
+  return giftwrap_hull(points, 0);
+}
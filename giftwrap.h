@@ -0,0 +1,33 @@
+#ifndef __giftwrap_h
+#define __giftwrap_h
+
+#include "geom.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* compute and return the convex hull of the points by gift wrapping,
+   as brute_force_hull does. the points strictly inside the hull of
+   the extreme points in 26 directions are dropped first (Akl and
+   Toussaint), then each face of the hull is found by rotating a plane
+   around an edge of a face already found, in O(n) per face: O(n h)
+   in all, which beats the other engines when the hull is small.
+   coplanar points make a single facet, which is triangulated as a fan;
+   collinear and duplicated points are handled. the prefilter is split
+   over nthreads threads (0 means one per core) */
+vector<triangle3d> giftwrap_hull(vector<point3d> &points, int nthreads);
+
+/* the indices of the points that are furthest in each of the 26
+   directions (+-1, 0)^3, without repeats. they are on the hull, and
+   their hull is a good part of the hull of the points */
+void extreme_points(vector<point3d> &points, vector<int> &ext);
+
+/* giftwrap_hull() with one thread per core, with the signature of
+   brute_force_hull() */
+vector<triangle3d> giftwrap_hull(vector<point3d> &points);
+
+#endif
@@ -0,0 +1,474 @@
+/*  gjk.cpp
+ *
+ *  distance, intersection and penetration depth of two hulls.
+ *
+ *  GJK looks for the point of a - b = {p - q : p in a, q in b} closest
+ *  to the origin: the hulls intersect when the origin is in a - b, and
+ *  their distance is its distance to a - b otherwise. a - b is never
+ *  built; its vertex furthest in a direction d is the vertex of a
+ *  furthest in d minus the vertex of b furthest in -d.
+ *
+ *  the points are integers but the simplices are solved in doubles,
+ *  with tolerances relative to the size of the shapes.
+ *
+ */
+
+
+#include "gjk.h"
+#include "hullcodec.h"
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+//steps after which GJK and EPA give their best so far. the vertices
+//are finite, so they only end this way when rounding makes them cycle
+const int GJK_STEPS = 128;
+const int EPA_STEPS = 256;
+
+//relative tolerance on squared lengths
+const double GJK_EPS = 1e-12;
+
+
+static double dot(const double a[3], const double b[3]) {
+  return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+static void cross(const double a[3], const double b[3], double out[3]) {
+  out[0] = a[1]*b[2] - a[2]*b[1];
+  out[1] = a[2]*b[0] - a[0]*b[2];
+  out[2] = a[0]*b[1] - a[1]*b[0];
+}
+
+static void sub(const double a[3], const double b[3], double out[3]) {
+  for (int i = 0; i < 3; i++) out[i] = a[i] - b[i];
+}
+
+static double point_dot(point3d p, const double d[3]) {
+  return p.x * d[0] + p.y * d[1] + p.z * d[2];
+}
+
+
+void convex_shape_from_faces(vector<triangle3d> &faces, convex_shape *out) {
+
+  hull_data data;
+  hull_data_from_faces(faces, &data);
+  out->vertex = data.vertex;
+
+  //both directions of every edge, grouped by their first vertex
+  vector<pair<int, int> > edge;
+  for (size_t k = 0; k + 2 < data.face.size(); k += 3) {
+    for (int i = 0; i < 3; i++) {
+      int a = data.face[k+i], b = data.face[k+(i+1)%3];
+      edge.push_back(make_pair(a, b));
+      edge.push_back(make_pair(b, a));
+    }
+  }
+  sort(edge.begin(), edge.end());
+  edge.erase(unique(edge.begin(), edge.end()), edge.end());
+
+  int nv = out->vertex.size();
+  out->first.assign(nv + 1, 0);
+  out->adj.clear();
+  for (size_t e = 0; e < edge.size(); e++) {
+    out->first[edge[e].first + 1]++;
+    out->adj.push_back(edge[e].second);
+  }
+  for (int v = 0; v < nv; v++) out->first[v+1] += out->first[v];
+}
+
+
+int shape_support(const convex_shape *s, const double d[3], int start) {
+
+  int n = s->vertex.size();
+  if (s->adj.empty()) {
+    int best = 0;
+    for (int v = 1; v < n; v++) {
+      if (point_dot(s->vertex[v], d) > point_dot(s->vertex[best], d)) best = v;
+    }
+    return best;
+  }
+
+  int v = start;
+  double h = point_dot(s->vertex[v], d);
+  while (true) {
+    int next = v;
+    for (int k = s->first[v]; k < s->first[v+1]; k++) {
+      double hk = point_dot(s->vertex[s->adj[k]], d);
+      if (hk > h) {
+        h = hk;
+        next = s->adj[k];
+      }
+    }
+    if (next == v) return v;
+    v = next;
+  }
+}
+
+
+/* a vertex of a - b, and the vertices of a and b it comes from */
+typedef struct _diff_point {
+  double w[3];
+  int ia, ib;
+} diff_point;
+
+/* the current simplex, and the weights of its points in the point
+   closest to the origin */
+typedef struct _simplex {
+  int n;
+  diff_point p[4];
+  double lambda[4];
+} simplex;
+
+/* the vertex of a - b furthest in direction d. ha and hb are where
+   the hill climbing starts, and are moved to what it finds */
+static diff_point support(const convex_shape *a, const convex_shape *b, const double d[3],
+                          int *ha, int *hb) {
+
+  double nd[3] = {-d[0], -d[1], -d[2]};
+  *ha = shape_support(a, d, *ha);
+  *hb = shape_support(b, nd, *hb);
+  point3d p = a->vertex[*ha], q = b->vertex[*hb];
+  diff_point w = {{(double)p.x - q.x, (double)p.y - q.y, (double)p.z - q.z}, *ha, *hb};
+  return w;
+}
+
+
+/* solve the k x k system m x = r (k <= 3) by elimination with partial
+   pivoting. returns 0 if m is singular relative to its size */
+static int solve(double m[3][3], double r[3], int k, double x[3]) {
+
+  double scale = 0;
+  for (int i = 0; i < k; i++) scale = max(scale, fabs(m[i][i]));
+  for (int c = 0; c < k; c++) {
+    int pivot = c;
+    for (int i = c+1; i < k; i++) {
+      if (fabs(m[i][c]) > fabs(m[pivot][c])) pivot = i;
+    }
+    if (fabs(m[pivot][c]) <= 1e-12 * scale) return 0;
+    for (int j = 0; j < k; j++) swap(m[c][j], m[pivot][j]);
+    swap(r[c], r[pivot]);
+    for (int i = c+1; i < k; i++) {
+      double f = m[i][c] / m[c][c];
+      for (int j = c; j < k; j++) m[i][j] -= f * m[c][j];
+      r[i] -= f * r[c];
+    }
+  }
+  for (int i = k-1; i >= 0; i--) {
+    double t = r[i];
+    for (int j = i+1; j < k; j++) t -= m[i][j] * x[j];
+    x[i] = t / m[i][i];
+  }
+  return 1;
+}
+
+/* reduce s to the face of it whose relative interior holds the point
+   closest to the origin, with the weights of that point, and write it
+   to v. every face is tried: the closest point of its affine hull is
+   in the simplex when all its weights are positive, and the nearest of
+   those is the closest point of the simplex */
+static void closest_point(simplex *s, double v[3]) {
+
+  double best = DBL_MAX, best_lambda[4] = {0, 0, 0, 0};
+  int best_set = 1;
+  for (int set = 1; set < (1 << s->n); set++) {
+    int id[4], k = 0;
+    for (int i = 0; i < s->n; i++) {
+      if (set & (1 << i)) id[k++] = i;
+    }
+
+    //the point w0 + sum mu_j (w_j - w0) closest to the origin
+    double e[3][3], m[3][3], r[3], mu[3] = {0, 0, 0};
+    const double *w0 = s->p[id[0]].w;
+    for (int j = 1; j < k; j++) sub(s->p[id[j]].w, w0, e[j-1]);
+    for (int j = 0; j < k-1; j++) {
+      for (int l = 0; l < k-1; l++) m[j][l] = dot(e[j], e[l]);
+      r[j] = -dot(e[j], w0);
+    }
+    if (k > 1 && !solve(m, r, k-1, mu)) continue;
+
+    double lambda[4], sum = 0, c[3] = {w0[0], w0[1], w0[2]};
+    int inside = 1;
+    for (int j = 1; j < k; j++) {
+      lambda[j] = mu[j-1];
+      sum += mu[j-1];
+      if (mu[j-1] <= 0) inside = 0;
+      for (int i = 0; i < 3; i++) c[i] += mu[j-1] * e[j-1][i];
+    }
+    lambda[0] = 1 - sum;
+    if (lambda[0] <= 0 && k > 1) inside = 0;
+    if (!inside || dot(c, c) >= best) continue;
+
+    best = dot(c, c);
+    best_set = set;
+    for (int i = 0; i < 3; i++) v[i] = c[i];
+    for (int j = 0; j < k; j++) best_lambda[j] = lambda[j];
+  }
+
+  int k = 0;
+  for (int i = 0; i < s->n; i++) {
+    if (!(best_set & (1 << i))) continue;
+    s->p[k] = s->p[i];
+    s->lambda[k] = best_lambda[k];
+    k++;
+  }
+  s->n = k;
+}
+
+
+/* a face of the EPA polytope, outward normal n at distance d from the
+   origin */
+typedef struct _epa_face {
+  int v[3];
+  double n[3], d;
+} epa_face;
+
+static epa_face make_epa_face(vector<diff_point> &pts, int a, int b, int c) {
+
+  epa_face f = {{a, b, c}, {0, 0, 0}, DBL_MAX};
+  double u[3], w[3];
+  sub(pts[b].w, pts[a].w, u);
+  sub(pts[c].w, pts[a].w, w);
+  cross(u, w, f.n);
+  double len = sqrt(dot(f.n, f.n));
+  if (len > 0) {
+    for (int i = 0; i < 3; i++) f.n[i] /= len;
+    f.d = dot(f.n, pts[a].w);
+  }
+  return f;
+}
+
+/* directions in which to look for a point of a - b off the affine
+   hull of the first k points */
+static int spread_directions(vector<diff_point> &pts, double dirs[6][3]) {
+
+  int k = pts.size();
+  if (k == 1) {
+    for (int i = 0; i < 6; i++) {
+      for (int j = 0; j < 3; j++) dirs[i][j] = (j == i/2) ? ((i & 1) ? -1 : 1) : 0;
+    }
+    return 6;
+  }
+  double u[3], w[3], n[3];
+  sub(pts[1].w, pts[0].w, u);
+  if (k == 2) {
+    //two directions across the segment, and their opposites
+    int axis = 0;
+    for (int i = 1; i < 3; i++) {
+      if (fabs(u[i]) < fabs(u[axis])) axis = i;
+    }
+    double e[3] = {0, 0, 0};
+    e[axis] = 1;
+    cross(u, e, n);
+    cross(u, n, w);
+    for (int j = 0; j < 3; j++) {
+      dirs[0][j] = n[j];
+      dirs[1][j] = -n[j];
+      dirs[2][j] = w[j];
+      dirs[3][j] = -w[j];
+    }
+    return 4;
+  }
+  sub(pts[2].w, pts[0].w, w);
+  cross(u, w, n);
+  for (int j = 0; j < 3; j++) {
+    dirs[0][j] = n[j];
+    dirs[1][j] = -n[j];
+  }
+  return 2;
+}
+
+/* how far w is from the affine hull of the points, relative to scale */
+static int off_hull(vector<diff_point> &pts, diff_point &w, double scale) {
+
+  double u[3], t[3], n[3];
+  sub(w.w, pts[0].w, t);
+  if (pts.size() == 1) return dot(t, t) > GJK_EPS * scale * scale;
+  sub(pts[1].w, pts[0].w, u);
+  if (pts.size() == 2) {
+    cross(u, t, n);
+    return dot(n, n) > GJK_EPS * dot(u, u) * scale * scale;
+  }
+  double v[3];
+  sub(pts[2].w, pts[0].w, v);
+  cross(u, v, n);
+  double h = dot(n, t);
+  return h * h > GJK_EPS * dot(n, n) * scale * scale;
+}
+
+/* the penetration depth and normal of a and b, whose difference holds
+   the origin in the simplex s, by expanding s into a polytope whose
+   face nearest to the origin is also a face of a - b */
+static void epa(const convex_shape *a, const convex_shape *b, simplex *s, double scale,
+                int ha, int hb, hull_query *out) {
+
+  vector<diff_point> pts(s->p, s->p + s->n);
+
+  //a tetrahedron: the origin is in the simplex, so it stays inside
+  while (pts.size() < 4) {
+    double dirs[6][3];
+    int nd = spread_directions(pts, dirs), found = 0;
+    for (int i = 0; i < nd && !found; i++) {
+      diff_point w = support(a, b, dirs[i], &ha, &hb);
+      if (off_hull(pts, w, scale)) {
+        pts.push_back(w);
+        found = 1;
+      }
+    }
+    if (!found) {
+      //a - b is flat: the hulls only touch
+      out->depth = 0;
+      return;
+    }
+  }
+
+  vector<epa_face> faces;
+  double u[3], v[3], t[3], n[3];
+  sub(pts[1].w, pts[0].w, u);
+  sub(pts[2].w, pts[0].w, v);
+  sub(pts[3].w, pts[0].w, t);
+  cross(u, v, n);
+  if (dot(n, t) > 0) swap(pts[1], pts[2]);
+  faces.push_back(make_epa_face(pts, 0, 1, 2));
+  faces.push_back(make_epa_face(pts, 0, 3, 1));
+  faces.push_back(make_epa_face(pts, 0, 2, 3));
+  faces.push_back(make_epa_face(pts, 1, 3, 2));
+
+  double tol = 1e-9 * scale;
+  int nearest = 0;
+  for (int step = 0; step < EPA_STEPS; step++) {
+    out->iterations++;
+    nearest = 0;
+    for (size_t f = 1; f < faces.size(); f++) {
+      if (faces[f].d < faces[nearest].d) nearest = f;
+    }
+    epa_face near = faces[nearest];
+    diff_point w = support(a, b, near.n, &ha, &hb);
+    if (dot(near.n, w.w) - near.d <= tol) break;
+
+    //remove the faces w sees; the edges used once by them are the
+    //horizon, which is joined to w
+    int iw = pts.size();
+    pts.push_back(w);
+    vector<pair<int, int> > horizon;
+    size_t kept = 0;
+    for (size_t f = 0; f < faces.size(); f++) {
+      if (dot(faces[f].n, w.w) - faces[f].d <= tol) {
+        faces[kept++] = faces[f];
+        continue;
+      }
+      for (int i = 0; i < 3; i++) {
+        pair<int, int> e(faces[f].v[i], faces[f].v[(i+1)%3]);
+        vector<pair<int, int> >::iterator back =
+          find(horizon.begin(), horizon.end(), make_pair(e.second, e.first));
+        if (back != horizon.end()) {
+          horizon.erase(back);
+        } else {
+          horizon.push_back(e);
+        }
+      }
+    }
+    faces.resize(kept);
+    if (horizon.empty()) break;
+    for (size_t e = 0; e < horizon.size(); e++) {
+      faces.push_back(make_epa_face(pts, horizon[e].first, horizon[e].second, iw));
+    }
+    nearest = 0;
+  }
+
+  for (size_t f = 1; f < faces.size(); f++) {
+    if (faces[f].d < faces[nearest].d) nearest = f;
+  }
+  out->depth = max(0.0, faces[nearest].d);
+  for (int i = 0; i < 3; i++) out->normal[i] = faces[nearest].n[i];
+}
+
+
+void hull_gjk(const convex_shape *a, const convex_shape *b, int penetration, hull_query *out) {
+
+  memset(out, 0, sizeof(hull_query));
+  if (a->vertex.empty() || b->vertex.empty()) {
+    out->distance = DBL_MAX;
+    return;
+  }
+
+  int ha = 0, hb = 0;
+  simplex s;
+  double zero[3] = {0, 0, 0}, v[3];
+  s.n = 1;
+  s.p[0] = support(a, b, zero, &ha, &hb);
+  s.lambda[0] = 1;
+  for (int i = 0; i < 3; i++) v[i] = s.p[0].w[i];
+  double scale = sqrt(dot(v, v));
+
+  for (int step = 0; step < GJK_STEPS; step++) {
+    out->iterations++;
+    double vv = dot(v, v);
+    if (vv <= GJK_EPS * scale * scale || s.n == 4) {
+      out->intersect = 1;
+      break;
+    }
+
+    double d[3] = {-v[0], -v[1], -v[2]};
+    diff_point w = support(a, b, d, &ha, &hb);
+    scale = max(scale, sqrt(dot(w.w, w.w)));
+
+    //no vertex of a - b is closer than the simplex along v
+    if (vv - dot(v, w.w) <= GJK_EPS * vv) break;
+    int seen = 0;
+    for (int i = 0; i < s.n; i++) seen |= (s.p[i].ia == w.ia && s.p[i].ib == w.ib);
+    if (seen) break;
+
+    s.p[s.n++] = w;
+    closest_point(&s, v);
+  }
+
+  if (out->intersect) {
+    if (penetration) epa(a, b, &s, max(scale, 1.0), ha, hb, out);
+    return;
+  }
+
+  for (int i = 0; i < s.n; i++) {
+    point3d p = a->vertex[s.p[i].ia], q = b->vertex[s.p[i].ib];
+    out->on_a[0] += s.lambda[i] * p.x;
+    out->on_a[1] += s.lambda[i] * p.y;
+    out->on_a[2] += s.lambda[i] * p.z;
+    out->on_b[0] += s.lambda[i] * q.x;
+    out->on_b[1] += s.lambda[i] * q.y;
+    out->on_b[2] += s.lambda[i] * q.z;
+  }
+  out->distance = sqrt(dot(v, v));
+  for (int i = 0; i < 3; i++) out->normal[i] = -v[i] / out->distance;
+}
+
+
+/* queries k of pairs for from <= k < to */
+static void query_range(vector<convex_shape> *shapes, vector<pair<int, int> > *pairs,
+                        int penetration, vector<hull_query> *out, size_t from, size_t to) {
+  for (size_t k = from; k < to; k++) {
+    hull_gjk(&(*shapes)[(*pairs)[k].first], &(*shapes)[(*pairs)[k].second], penetration,
+             &(*out)[k]);
+  }
+}
+
+
+void hull_gjk_batch(vector<convex_shape> &shapes, vector<pair<int, int> > &pairs,
+                    int penetration, vector<hull_query> &out, int nthreads) {
+
+  out.resize(pairs.size());
+  if (nthreads <= 0) nthreads = thread::hardware_concurrency();
+  if (nthreads <= 0) nthreads = 1;
+
+  size_t chunk = (pairs.size() + nthreads - 1) / nthreads;
+  vector<thread> workers;
+  for (int t = 0; t < nthreads; t++) {
+    size_t from = min(pairs.size(), t * chunk), to = min(pairs.size(), from + chunk);
+    workers.push_back(thread(query_range, &shapes, &pairs, penetration, &out, from, to));
+  }
+  for (int t = 0; t < nthreads; t++) workers[t].join();
+}
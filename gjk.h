@@ -0,0 +1,58 @@
+#ifndef __gjk_h
+#define __gjk_h
+
+#include "geom.h"
+
+#include <utility>
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* a hull as its vertices and the edges between them, for support
+   queries. built once per hull and then only read, so any number of
+   threads can query it */
+typedef struct _convex_shape {
+  vector<point3d> vertex;
+  vector<int> first;       //the neighbours of v are adj[first[v]] .. adj[first[v+1]-1]
+  vector<int> adj;
+} convex_shape;
+
+/* what hull_gjk() found out about two shapes a and b */
+typedef struct _hull_query {
+  int intersect;           //1 if they touch or overlap
+  double distance;         //between them; 0 if they intersect
+  double depth;            //how far b must move along normal to only touch a; 0 if they do not intersect
+  double normal[3];        //unit vector from a towards b
+  double on_a[3], on_b[3]; //closest points, when they do not intersect
+  int iterations;          //GJK steps, then EPA steps
+} hull_query;
+
+
+/* the shape of a hull given as a face list. a shape with vertices but
+   no edges is also valid: its support queries look at every vertex */
+void convex_shape_from_faces(vector<triangle3d> &faces, convex_shape *out);
+
+/* the vertex of s furthest in direction d, by hill climbing along the
+   edges from vertex start: on a convex polytope a vertex with no
+   better neighbour is the best of all */
+int shape_support(const convex_shape *s, const double d[3], int start);
+
+
+/* distance and intersection of a and b by GJK: the point of the
+   Minkowski difference a - b closest to the origin is found on a
+   simplex of at most 4 of its vertices, each given by a support query
+   on a and on b. each query starts at the vertex the previous one
+   found, so a step walks a few edges. if they intersect and
+   penetration is set, EPA expands the last simplex into the part of
+   a - b around the origin to find the penetration depth and normal */
+void hull_gjk(const convex_shape *a, const convex_shape *b, int penetration, hull_query *out);
+
+/* hull_gjk() on the pairs of shapes, split over nthreads threads (0
+   means one per core). out[k] is the query of pairs[k] */
+void hull_gjk_batch(vector<convex_shape> &shapes, vector<pair<int, int> > &pairs,
+                    int penetration, vector<hull_query> &out, int nthreads);
+
+#endif
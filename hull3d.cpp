@@ -10,11 +10,21 @@ Laura Toma
 */
 
 #include "geom.h"
+#include "hullcheck.h"
+#include "hullmetrics.h"
+#include "obb.h"
+#include "kinetic.h"
+#include "pointgen.h"
+#include "hullselect.h"
+#include "lod.h"
+#include "compacthull.h"
+#include "delaunay.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 #include <assert.h>
+#include <string.h>
 //this allows this code to compile both on apple and linux platforms
 #ifdef __APPLE__
 #include <GLUT/glut.h>
@@ -38,11 +48,43 @@ vector<point3d>  points;
 
 int n;  //desired number of points
 
+//seed of the next point set; every keypress makes a new one
+unsigned long long seed = 1;
+
 
 //the convex hull, stored as a list. note: this variable needs to be
 //global because it needs to be rendered
 vector<triangle3d>  hull;
 
+//volume, area, centroid etc of the hull; computed on demand and
+//invalidated whenever the hull is recomputed
+hull_metrics metrics;
+
+//how the hull is computed: the engine is chosen from the points unless
+//one is given on the command line
+hull_options options = {NULL, 0, 1, 0};
+
+//when animating, the points jitter every frame and the hull is kept
+//up to date by the kinetic hull instead of being recomputed
+kinetic_hull kinetic;
+int animating = 0;
+
+//the exact minimum volume box projects the hull a few hundred times per
+//edge, so the 'o' key only fits it on hulls with at most this many vertices
+int obb_exact_vertices = 500;
+
+//coarser hulls that contain the hull, built when it has more than
+//LOD_FACES faces. draw_hull() allows LOD_ERROR extra volume per unit
+//of distance to the camera
+vector<hull_level> lod;
+const int LOD_FACES = 2000;
+const double LOD_ERROR = 0.01;
+
+//the Delaunay triangulation of the points by x and y, drawn as a
+//terrain instead of the hull when show_delaunay is set
+vector<int> delaunay;
+int show_delaunay = 0;
+
 
 const int WINDOWSIZE = 500;
 
@@ -68,47 +110,50 @@ GLint fillmode = 0;
 /* forward declarations of functions */
 void display(void);
 void keypress(unsigned char key, int x, int y);
-void initialize_points_random();
 void draw_points();
 void draw_hull();
+void draw_delaunay();
 void draw_xy_rect(GLfloat z, GLfloat* col);
 void draw_xz_rect(GLfloat y, GLfloat* col);
 void draw_yz_rect(GLfloat x, GLfloat* col);
 void cube(GLfloat side);
 void filledcube(GLfloat side);
 void draw_axes();
-void initialize_points_spring();
-void draw_sphere(float rad, float x, float y, float z);
-void initialize_points_heart();
-void initialize_points_house();
-void initialize_points_random_vertlines();
-void draw_sphereOfSpheres();
-void initialize_points_personal();
-void initialize_points_cross();
-void initialize_points_pyramid();
-void beautiful_diamond();
-void initialize_points_droplet();
+void recompute_hull();
+void recompute_delaunay();
+void make_points(const char *name);
+void animate_points();
 
 int main(int argc, char** argv) {
 
+  //run the hull checks instead of the viewer
+  if (argc >= 2 && strcmp(argv[1], "-check") == 0) {
+    int trials = (argc > 2) ? atoi(argv[2]) : 10;
+    unsigned int seed = (argc > 3) ? atoi(argv[3]) : 1;
+    exit(run_hull_checks(seed, trials, 0) == 0 ? 0 : 1);
+  }
+
   //read number of points from user
-  if (argc!=2) {
-    printf("usage: hull3d <nbPoints>\n");
+  if (argc!=2 && argc!=3) {
+    printf("usage: hull3d <nbPoints> [engine]\n");
+    printf("       hull3d -check [trials] [seed]\n");
     exit(1);
   }
   n = atoi(argv[1]);
   printf("you entered n=%d\n", n);
+  if (argc == 3) options.engine = argv[2];
   assert(n>0);
 
-  //initialize_points_random();
-  initialize_points_droplet();
+  //make_points("random");
+  make_points("droplet");
 
   for (int i = 0; i < points.size(); ++i) {
     printf("point: %d %d %d\n", points[i].x, points[i].y, points[i].z);
   }
 
-  hull = brute_force_hull(points);
+  recompute_hull();
   //print_hull(hull);
+  print_hull_metrics(cached_hull_metrics(hull, &metrics, 0));
 
   /* open a window and initialize GLUT stuff */
   glutInit(&argc, argv);
@@ -178,7 +223,8 @@ void display(void) {
   we draw the object in the local system, and we translate
   the system. */
   draw_points();
-  draw_hull();
+  if (show_delaunay) draw_delaunay();
+  else draw_hull();
 
   //don't need to draw a cube but I found it cool for perspective
   cube(1);
@@ -196,55 +242,80 @@ void keypress(unsigned char key, int x, int y) {
 
     case 'i':
     //re-initialize
-    initialize_points_random();
+    make_points("random");
     //re-compute
-    hull = brute_force_hull(points);
+    recompute_hull();
     glutPostRedisplay();
     break;
     case 'j':
-    initialize_points_pyramid();
-    hull = brute_force_hull(points);
+    make_points("pyramid");
+    recompute_hull();
     glutPostRedisplay();
     break;
     case 'k':
-    initialize_points_cross();
-    hull = brute_force_hull(points);
+    make_points("cross");
+    recompute_hull();
     glutPostRedisplay();
     break;
 
     case 'm':
-    beautiful_diamond();
-    hull = brute_force_hull(points);
+    make_points("diamond");
+    recompute_hull();
     glutPostRedisplay();
     break;
 
     case 'n':
-    initialize_points_spring();
-    hull = brute_force_hull(points);
+    make_points("spring");
+    recompute_hull();
     glutPostRedisplay();
     break;
 
     case 'p':
-    draw_sphereOfSpheres();
-    hull = brute_force_hull(points);
+    make_points("sphereOfSpheres");
+    recompute_hull();
     glutPostRedisplay();
     break;
 
     case 's':
-    initialize_points_random_vertlines();
-    hull = brute_force_hull(points);
+    make_points("vertlines");
+    recompute_hull();
     glutPostRedisplay();
     break;
 
     case 't':
-    initialize_points_heart();
-    hull = brute_force_hull(points);
+    make_points("heart");
+    recompute_hull();
     glutPostRedisplay();
     break;
 
     case 'w':
-    initialize_points_droplet();
-    hull = brute_force_hull(points);
+    make_points("droplet");
+    recompute_hull();
+    glutPostRedisplay();
+    break;
+
+    //larger random sets
+    case 'e':
+    make_points("ball");
+    recompute_hull();
+    glutPostRedisplay();
+    break;
+
+    case 'g':
+    make_points("sphere");
+    recompute_hull();
+    glutPostRedisplay();
+    break;
+
+    case 'h':
+    make_points("clusters");
+    recompute_hull();
+    glutPostRedisplay();
+    break;
+
+    case 'K':
+    make_points("kissing");
+    recompute_hull();
     glutPostRedisplay();
     break;
     //ROTATIONS
@@ -308,6 +379,59 @@ void keypress(unsigned char key, int x, int y) {
     glutPostRedisplay();
     break;
 
+    //print the volume, area, centroid etc of the hull
+    case 'v': {
+      print_hull_metrics(cached_hull_metrics(hull, &metrics, 0));
+      compact_hull compact;
+      hull_memory memory;
+      compact_hull_from_faces(points, hull, &compact);
+      hull_memory_usage(&hull, &compact, &memory);
+      print_hull_memory(&memory);
+      break;
+    }
+
+    //print the PCA, the sampled and the exact minimum volume bounding boxes
+    case 'o': {
+      hull_mesh mesh;
+      obb box;
+      build_hull_mesh(points, hull, &mesh);
+      obb_pca(points, &mesh, cached_hull_metrics(hull, &metrics, 0), &box);
+      print_obb(&box);
+      obb_sampled(points, &mesh, &metrics, 4, &box, 0);
+      print_obb(&box);
+      if ((int)mesh.vert.size() <= obb_exact_vertices) {
+        obb_exact(points, &mesh, &metrics, &box, 0);
+        print_obb(&box);
+      } else {
+        printf("obb: %d hull vertices, the exact box is only fitted up to %d\n",
+               (int)mesh.vert.size(), obb_exact_vertices);
+      }
+    }
+    break;
+
+    //start or stop moving the points
+    case 'a':
+    animating = !animating;
+    if (animating) {
+      //the levels of detail would have to be rebuilt every frame
+      if (lod.size() > 0) printf("levels of detail off while the points move\n");
+      lod.clear();
+      kinetic_hull_init(&kinetic, &points);
+      glutIdleFunc(animate_points);
+    } else {
+      glutIdleFunc(NULL);
+      if (hull.size() > LOD_FACES) build_hull_lod(hull, lod);
+      glutPostRedisplay();
+    }
+    break;
+
+    //draw the Delaunay triangulation instead of the hull
+    case 'D':
+    show_delaunay = !show_delaunay;
+    if (show_delaunay) recompute_delaunay();
+    glutPostRedisplay();
+    break;
+
     //fillmode
     case 'c':
     fillmode = !fillmode;
@@ -320,253 +444,60 @@ void keypress(unsigned char key, int x, int y) {
   }
 }//keypress
 
-/* Jack's spiral/spring initializer */
-void initialize_points_spring() {
 
-  //clear the vector just to be safe
-  points.clear();
+/* replace the points by the set called name (see pointgen.h), with n
+points if the set can have any number */
+void make_points(const char *name) {
 
-  int i;
-  point3d p;
-  float step = WINDOWSIZE / n;
-  for (i = 0; i < n; i++) {
-    p.x = (int)(WINDOWSIZE * ((cos(i * step) + 1) * .5));
-    p.y = (int)(WINDOWSIZE * ((sin(i * step) + 1) * .5));
-    p.z = (int)(i * step);
-    points.push_back(p);
-  }
+  gen_params g = {n, seed++, WINDOWSIZE, 0, 0};
+  generate_points(name, &g, points, 0);
 }
 
 
-//draw points sampled on a sphere of radius rad with
-//an orgin at x, y, z as input parameters
-void draw_sphere(float rad, float x, float y, float z) {
-
-  point3d p;
+/* recompute the hull of the points, dropping whatever was derived
+from the old one */
+void recompute_hull() {
 
-  int N = 6;
-  float u = 2*M_PI/N;
-  float v = M_PI/N;
-
-  for (int i = 0; i < N; i++) {
-    for (int j = 0; j < N; j++) {
-      p.x = x + rad * cos(u * i) * sin(v * j);
-      p.y = y + rad * sin(u * i) * sin(v * j);
-      p.z = z + rad * cos(j*v);
-      points.push_back(p);
-    }
-  }
+  hull = compute_hull(points, &options);
+  metrics.valid = 0;
+  lod.clear();
+  if (hull.size() > LOD_FACES && !animating) build_hull_lod(hull, lod);
+  if (show_delaunay) recompute_delaunay();
+  if (animating) kinetic_hull_init(&kinetic, &points);
 }
 
 
-void initialize_points_droplet() {
-  points.clear();
-
-  point3d p;
-
-  int offset = 200;
-  int scaleX = 120;
-  int scaleY = 250;
-  int scaleZ = 520;
-
-  for (int i = 0; i < n; ++i) {
-    p.x = (int)scaleX*(1 - sin(i)) * cos(i) + offset;
-    p.y = (int)scaleY*(sin(1-i)) + offset;
-    p.z = -random() % scaleZ;
+/* triangulate the points by their x and y */
+void recompute_delaunay() {
 
-    points.push_back(p);
+  vector<point2d> flat(points.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    flat[i].x = points[i].x;
+    flat[i].y = points[i].y;
   }
-
-}
-
-/* heart test case */
-void initialize_points_heart() {
-  //clear the points just to be safe
-  points.clear();
-
-  int i;
-  point3d p;
-
-  float R = 100;
-
-  for (i = 0; i < n; i++) {
-    p.x = R*4.f*pow(sin(i),3.f);
-    p.y = R*0.25f*(13*cos(i)-5*cos(2.f*i)-2.f*cos(3.f*i)-cos(4.f*i));
-    p.z = random() % 200;
-    points.push_back(p);
-  }
-}
-
-void initialize_points_house(){
-  points.clear();
-  //draw a house
-  point3d p;
-  for (int j = 1; j < 11; j++){
-    int i = j;
-    int ymult = 1;
-    if (i>5){
-      i = i-5;
-      ymult = 2;
-    }
-    if(i < 3){
-      p.x = 125;
-      p.y = 125*ymult;
-      p.z = 125*i;
-    }
-    if (i == 3 ){
-      p.x = 250;
-      p.y = 125*ymult;
-      p.z = 375;
-    }
-    if (i > 3){
-      p.x = 375;
-      p.y = 125*ymult;
-      p.z = 125*(i-3);
-    }
-    points.push_back(p);
+  if (delaunay_triangulation(flat, delaunay) < 0) {
+    printf("the points are too far apart to triangulate\n");
   }
-
 }
 
-//creates random location vetical lines
-//that are five points in length
-//Ryan St. Pierre testcase
-void initialize_points_random_vertlines() {
-
-  //clear the vector just to be safe                                                                                                                                                          \
 
-  points.clear();
+/* idle function while animating: move every point by at most 1 in
+each coordinate and let the kinetic hull repair itself */
+void animate_points() {
 
-  int i;
-  point3d p;
-  int x;
-  int y;
-  //outer loop for each line
-  for(int i = 0; i< n/5; i++){
-    x = (int)(.3*WINDOWSIZE)/2 + random() % ((int)(.7*WINDOWSIZE));
-    y = (int)(.3*WINDOWSIZE)/2 + random() % ((int)(.7*WINDOWSIZE));
-    //inner loop to determin z-coordinate of each point in the line
-    for (int k=0; k<5; k++) {
-      p.x = x;
-      p.y = y;
-      p.z=  (int)(.3*WINDOWSIZE)/2 + random() % ((int)(.7*WINDOWSIZE));
-      points.push_back(p);
-    }
-  }
-}
-
-void draw_sphereOfSpheres() {
-
-  points.clear();
-
-  point3d p;
-  int NR = 2;
-  float rMax = 200.0;
-  float dr = rMax / NR;
-  int NPhi = 3;
-  int NTheta = 3;
-  float dphi = 2*M_PI/NPhi;
-  float dtheta = M_PI/NTheta;
-  float x;
-  float y;
-  float z;
-
-  //For each point IN and ON sphere, draw a spherical shell
-  for (int i = 0; i < NTheta; i++) {
-    for (int j = 0; j < NPhi; j++){
-      for (int k = 1; k < NR; k++){
-
-        x = WINDOWSIZE/2 + (dr * k) * sin(dtheta * i)*cos(dphi * j);
-        y = WINDOWSIZE/2 + (dr * k) * sin(dtheta * i)*sin(dphi * j);
-        z = WINDOWSIZE/2 + (dr * k) * cos(dtheta * i);
-        draw_sphere(rMax,x,y,z);
-      }
-    }
-  }
-
-  // where is the part where you add the point? Oh, so you are just drawing them for fun?
-}
-
-void initialize_points_personal() {
-
-  glTranslatef(0,0,0);
-
-  glMatrixMode(GL_PROJECTION);
-  glLoadIdentity();
-  gluPerspective(100, 1 /* aspect */, 1, 10.0);
-
-  points.clear();
-  point3d p;
-
-  glColor3fv(blue);
-
-  float rad = 400;
-  float u = 2*M_PI/n;
-  float v = 2*M_PI/n;
-
-  int i;
-  for (i=0; i<n; i++) {
-
-    p.x = rad * cos (6i*u) * sin(i*v) + 330;
-    p.y = rad * sin (3*i*u) * sin(i*v) + 50;
-    p.z = rad * cos(i*v);
-
-    glTranslatef(p.x,p.y,p.z);
-    cube(.01);
-    glTranslatef(-p.x,-p.y,-p.z);
-
-    points.push_back(p);
-
-  }
-}
-
-
-
-
-
-
-
-/* initialize the array of points stored in global variable points[]
-with random points in the range x= [0,WINDOWSIZE],
-y=[0,WINDOWSIZE], z=[0,WINDOWSIZE] */
-void initialize_points_random() {
-
-  //clear the vector just to be safe
-  points.clear();
-
-  int i;
-  point3d p;
-  for (i=0; i<n; i++) {
-    p.x = (int)(.3*WINDOWSIZE)/2 + random() % ((int)(.7*WINDOWSIZE));
-    p.y =  (int)(.3*WINDOWSIZE)/2 + random() % ((int)(.7*WINDOWSIZE));
-    p.z=  (int)(.3*WINDOWSIZE)/2 + random() % ((int)(.7*WINDOWSIZE));
-    points.push_back(p);
+  vector<point3d> disp(points.size());
+  for (size_t i = 0; i < disp.size(); i++) {
+    disp[i].x = random() % 3 - 1;
+    disp[i].y = random() % 3 - 1;
+    disp[i].z = random() % 3 - 1;
   }
+  kinetic_hull_step(&kinetic, disp);
+  hull = kinetic.hull;
+  metrics.valid = 0;
+  if (show_delaunay) recompute_delaunay();
+  glutPostRedisplay();
 }
 
-void initialize_points_cross() {
-
-  //clear the vector just to be safe
-  points.clear();
-
-  int i;
-  point3d p;
-  for (i=0; i<n/2; i++) {
-    p.x = (int)(.3*WINDOWSIZE)/2 + random() % ((int)(.5*WINDOWSIZE));
-    p.y = (int)(.3*WINDOWSIZE)/2 + random() % ((int)(.5*WINDOWSIZE));
-    p.z =  250;
-    points.push_back(p);
-  }
-  for (i=0; i<n/2; i++){
-    p.x = (int)(.5*WINDOWSIZE)/2 + random() % ((int)(.5*WINDOWSIZE));
-    p.y = 250;
-    p.z = (int)(.5*WINDOWSIZE)/2 + random() % ((int)(.5*WINDOWSIZE));
-    points.push_back(p);
-  }
-}
-
-
-
 
 /* x is a value in [0,WINDOWSIZE] is mapped to [-1,1] */
 GLfloat windowtoscreen(GLfloat x) {
@@ -610,58 +541,9 @@ void draw_points(){
 
 }//draw_points
 
-void initialize_points_pyramid(){
-  //clear the vector just to be safe
-  points.clear();
-  float maxZ = WINDOWSIZE;
-  float minZ = WINDOWSIZE/5;
-  float midZ = (maxZ - minZ)/2;
-  float maxX = WINDOWSIZE;
-  float minX = WINDOWSIZE/5;
-  float midX = (maxX + minX)/2;
-  float maxY = WINDOWSIZE;
-  float minY = WINDOWSIZE/5;
-  float midY = (maxY + minY)/2;
-  int i;
-  point3d p;
-  //first do the 5 endpoints
-  p.x = maxX;
-  p.y = minY;
-  p.z = minZ;
-  points.push_back(p);
-
-  p.x = maxX;
-  p.y = maxY;
-  p.z = minZ;
-  points.push_back(p);
-
-  p.x = minX;
-  p.y = minY;
-  p.z = minZ;
-  points.push_back(p);
-
-  p.x = minX;
-  p.y = maxY;
-  p.z = minZ;
-  points.push_back(p);
-
-  p.x = midX;
-  p.y = midY;
-  p.z = maxZ;
-  points.push_back(p);
-
-  for (i=0; i<n-5; i++) {
-    p.x = (midX+minX)/2 + ((maxX - minX)/2) * ((float)rand()) / ((float)(RAND_MAX));
-    p.y = (midY+minY)/2 + ((maxY - minY)/2) * ((float)rand()) / ((float)(RAND_MAX));
-    p.z = minZ + midZ * ((float)rand()) / ((float)(RAND_MAX));
-    points.push_back(p);
-  }
-}
-
-
-
 /* ****************************** */
-/* draw the list of points stored in global variable hull[].
+/* draw the list of points stored in global variable hull[], or the
+coarsest level of detail that is close enough from where the camera is.
 
 NOTE: the points are in the range x=[0, WINDOWSIZE], y=[0,
 WINDOWSIZE], z=[0, 10] and they must be mapped back into x=[-1,1],
@@ -674,18 +556,25 @@ void draw_hull(){
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 
-  if (hull.size() >0) {
+  //the camera is -pos[2] away
+  vector<triangle3d> coarse;
+  int level = lod.size() - 1;
+  if (lod.size() > 0) level = choose_hull_level(lod, LOD_ERROR * -pos[2]);
+  if (level < (int)lod.size() - 1) hull_data_triangles(&lod[level].hull, coarse);
+  vector<triangle3d> &drawn = (level < (int)lod.size() - 1) ? coarse : hull;
+
+  if (drawn.size() >0) {
     int i;
-    for (i=0; i< hull.size(); i++) {
+    for (i=0; i< drawn.size(); i++) {
 
       glColor4f(0.1, 0.2, 0.9, 0.4);
       glBegin(GL_POLYGON);
 
-      glVertex3f(windowtoscreen(hull[i].a->x), windowtoscreen(hull[i].a->y), windowtoscreen(hull[i].a->z));
+      glVertex3f(windowtoscreen(drawn[i].a->x), windowtoscreen(drawn[i].a->y), windowtoscreen(drawn[i].a->z));
 
-      glVertex3f(windowtoscreen(hull[i].b->x), windowtoscreen(hull[i].b->y), windowtoscreen(hull[i].b->z));
+      glVertex3f(windowtoscreen(drawn[i].b->x), windowtoscreen(drawn[i].b->y), windowtoscreen(drawn[i].b->z));
 
-      glVertex3f(windowtoscreen(hull[i].c->x), windowtoscreen(hull[i].c->y), windowtoscreen(hull[i].c->z));
+      glVertex3f(windowtoscreen(drawn[i].c->x), windowtoscreen(drawn[i].c->y), windowtoscreen(drawn[i].c->z));
       //  glPopMatrix();
 
       glEnd();
@@ -698,69 +587,21 @@ void draw_hull(){
 
 
 
-void beautiful_diamond() {
-
-  //clear the vector
-  points.clear();
-
-  //make top of pyramid
-  point3d top;
-  top.x = 0;
-  top.y = 200;
-  top.z = 0;
-  points.push_back(top);
-
-  //make bottom of pyramid
-  point3d bottom;
-  bottom.x = 0;
-  bottom.y = 100;
-  bottom.z = 0;
-  points.push_back(bottom);
-
-  //make point1 of square
-  point3d point1;
-  point1.x = 50;
-  point1.y = 150;
-  point1.z = 50;
-  points.push_back(point1);
-
-  //make point2 of square
-  point3d point2;
-  point2.x = -50;
-  point2.y = 150;
-  point2.z = 50;
-  points.push_back(point2);
-
-  //make point3 of square
-  point3d point3;
-  point3.x = 50;
-  point3.y = 150;
-  point3.z = -50;
-  points.push_back(point3);
-
-  //make point4 of square
-  point3d point4;
-  point4.x = -50;
-  point4.y = 150;
-  point4.z = -50;
-  points.push_back(point4);
-
-  //put all remaining points inside the pyramid
-  int remainingPoints = n - 6;
-  for(int i = 0; i < remainingPoints; ++i){
-    point3d temp;
-    temp.x = 0;
-    temp.y = 150;
-    temp.z = 0;
-    points.push_back(temp);
-  }
-
+/* draw the edges of the Delaunay triangles, each corner at its point */
+void draw_delaunay(){
 
+  glColor3fv(yellow);
+  for (size_t t = 0; t + 2 < delaunay.size(); t += 3) {
+    glBegin(GL_LINE_LOOP);
+    for (int i = 0; i < 3; i++) {
+      point3d &p = points[delaunay[t+i]];
+      glVertex3f(windowtoscreen(p.x), windowtoscreen(p.y), windowtoscreen(p.z));
+    }
+    glEnd();
+  }
 }
 
 
-
-
 //draw a square x=[-side,side] x y=[-side,side] at depth z
 void draw_xy_rect(GLfloat z, GLfloat side, GLfloat* col) {
 
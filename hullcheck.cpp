@@ -0,0 +1,1464 @@
+/*  hullcheck.cpp
+ *
+ *  certificates and differential tests for the convex hull engines.
+ *
+ *  a hull is accepted if it is a closed, consistently oriented
+ *  triangulated surface (V - E + F = 2), convex at each of its edges,
+ *  and no input point lies strictly outside one of its faces. small
+ *  inputs are also compared face by face against brute_force_hull().
+ *
+ */
+
+
+#include "hullcheck.h"
+#include "hullmetrics.h"
+#include "obb.h"
+#include "kinetic.h"
+#include "incremental.h"
+#include "giftwrap.h"
+#include "hullselect.h"
+#include "hullversion.h"
+#include "dedup.h"
+#include "hullcodec.h"
+#include "gjk.h"
+#include "lod.h"
+#include "compacthull.h"
+#include "delaunay.h"
+#include "pointgen.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+hull_engine_entry hull_engines[] = {
+  {"brute_force", brute_force_hull, 0, 40},
+  {"incremental", incremental_hull, 1, 0},
+  {"giftwrap", giftwrap_hull, 1, 0},
+  {"parallel", parallel_hull, 1, 0},
+  {"auto", auto_hull, 1, 0},
+  {NULL, NULL, 0, 0}
+};
+
+
+
+/* lexicographic order on the coordinates */
+static bool point_less(const point3d &a, const point3d &b) {
+  if (a.x != b.x) return a.x < b.x;
+  if (a.y != b.y) return a.y < b.y;
+  return a.z < b.z;
+}
+
+/* affine dimension of the points: 0 if they are all equal, 1 if they
+   are on a line, 2 if they are on a plane and 3 otherwise */
+static int affine_dim(vector<point3d> &points) {
+
+  size_t i = 1, j, k;
+  if (points.size() == 0) return 0;
+
+  while (i < points.size() && isEqual(points[i], points[0])) i++;
+  if (i == points.size()) return 0;
+
+  for (j = i+1; j < points.size() && on_line(points[0], points[i], points[j]); j++);
+  if (j >= points.size()) return 1;
+
+  for (k = 0; k < points.size(); k++) {
+    if (volume_sign(points[0], points[i], points[j], points[k]) != 0) return 3;
+  }
+  return 2;
+}
+
+
+
+/* a face plane evaluated in floating point, used to filter the
+   containment test before falling back on volume_sign() */
+typedef struct _face_plane {
+  double nx, ny, nz;    //inward normal (b-a)x(c-a)
+  double ax, ay, az;
+  double err;           //bound on the rounding error of outside_face()
+} face_plane;
+
+static face_plane make_plane(triangle3d t) {
+
+  face_plane f;
+  double ux = (double)t.b->x - t.a->x, uy = (double)t.b->y - t.a->y, uz = (double)t.b->z - t.a->z;
+  double vx = (double)t.c->x - t.a->x, vy = (double)t.c->y - t.a->y, vz = (double)t.c->z - t.a->z;
+
+  f.nx = uy*vz - uz*vy;
+  f.ny = uz*vx - ux*vz;
+  f.nz = ux*vy - uy*vx;
+  f.ax = t.a->x; f.ay = t.a->y; f.az = t.a->z;
+  f.err = 64 * DBL_EPSILON * (fabs(uy*vz) + fabs(uz*vy) + fabs(uz*vx) + fabs(ux*vz) +
+                              fabs(ux*vy) + fabs(uy*vx));
+  return f;
+}
+
+/* returns 1 if p is strictly outside the face t; 0 otherwise */
+static int outside_face(face_plane &f, triangle3d &t, point3d p) {
+
+  double dx = p.x - f.ax, dy = p.y - f.ay, dz = p.z - f.az;
+  double s = f.nx*dx + f.ny*dy + f.nz*dz;
+  double bound = f.err * (fabs(dx) + fabs(dy) + fabs(dz));
+
+  if (s > bound) return 0;
+  if (s < -bound) return 1;
+  return volume_sign(*t.a, *t.b, *t.c, p) > 0;
+}
+
+/* count the (point, face) pairs in points[lo..hi) with the point
+   strictly outside the face */
+static void count_outside(vector<point3d> *points, vector<triangle3d> *hull,
+                          vector<face_plane> *planes, size_t lo, size_t hi, long *count) {
+
+  long c = 0;
+  for (size_t i = lo; i < hi; i++) {
+    for (size_t f = 0; f < hull->size(); f++) {
+      c += outside_face((*planes)[f], (*hull)[f], (*points)[i]);
+    }
+  }
+  *count = c;
+}
+
+
+
+/* a directed edge u->v of face f, with u and v vertex ids */
+typedef struct _edge_rec {
+  int u, v, f;
+} edge_rec;
+
+static bool edge_less(const edge_rec &a, const edge_rec &b) {
+  if (a.u != b.u) return a.u < b.u;
+  return a.v < b.v;
+}
+
+
+hull_certificate certify_hull(vector<point3d> &points, vector<triangle3d> &hull,
+                              int nthreads) {
+
+  hull_certificate cert;
+  memset(&cert, 0, sizeof(cert));
+  cert.dim = affine_dim(points);
+  cert.nfaces = hull.size();
+
+  if (nthreads <= 0) nthreads = thread::hardware_concurrency();
+  if (nthreads <= 0) nthreads = 1;
+
+  //the corners must point into the input. vertices are identified by
+  //their coordinates, so that duplicated input points count once
+  const point3d *first = points.data(), *last = first + points.size();
+  vector<point3d> verts;
+  for (size_t f = 0; f < hull.size(); f++) {
+    point3d *corner[3] = {hull[f].a, hull[f].b, hull[f].c};
+    for (int i = 0; i < 3; i++) {
+      if (corner[i] < first || corner[i] >= last) {
+        cert.stray_vertices++;
+      } else {
+        verts.push_back(*corner[i]);
+      }
+    }
+  }
+  if (cert.stray_vertices > 0) {
+    //nothing else can be checked safely
+    return cert;
+  }
+  sort(verts.begin(), verts.end(), point_less);
+  verts.erase(unique(verts.begin(), verts.end(), isEqual), verts.end());
+  cert.nvertices = verts.size();
+
+  //faces must have non-zero area
+  vector<int> id(3 * hull.size());
+  for (size_t f = 0; f < hull.size(); f++) {
+    if (on_line(*hull[f].a, *hull[f].b, *hull[f].c)) cert.degenerate_faces++;
+    point3d *corner[3] = {hull[f].a, hull[f].b, hull[f].c};
+    for (int i = 0; i < 3; i++) {
+      id[3*f+i] = lower_bound(verts.begin(), verts.end(), *corner[i], point_less) - verts.begin();
+    }
+  }
+
+  //every directed edge u->v must have exactly one twin v->u, and the
+  //face across it must not bend outward
+  vector<edge_rec> edges(3 * hull.size());
+  for (size_t f = 0; f < hull.size(); f++) {
+    for (int i = 0; i < 3; i++) {
+      edge_rec e = {id[3*f+i], id[3*f+(i+1)%3], (int)f};
+      edges[3*f+i] = e;
+    }
+  }
+  sort(edges.begin(), edges.end(), edge_less);
+  for (size_t i = 0; i < edges.size(); i++) {
+    if (i+1 < edges.size() && !edge_less(edges[i], edges[i+1])) {
+      cert.bad_edges++;
+      continue;
+    }
+    edge_rec twin = {edges[i].v, edges[i].u, 0};
+    vector<edge_rec>::iterator it = lower_bound(edges.begin(), edges.end(), twin, edge_less);
+    if (it == edges.end() || edge_less(twin, *it)) {
+      cert.bad_edges++;
+      continue;
+    }
+    //the corner of the twin face that is not on the edge
+    triangle3d &t = hull[edges[i].f], &g = hull[it->f];
+    point3d *w = g.a;
+    if (id[3*it->f+1] != twin.u && id[3*it->f+1] != twin.v) w = g.b;
+    if (id[3*it->f+2] != twin.u && id[3*it->f+2] != twin.v) w = g.c;
+    if (volume_sign(*t.a, *t.b, *t.c, *w) > 0) cert.reflex_edges++;
+  }
+  cert.nedges = edges.size() / 2;
+
+  //every point must be inside or on every face. this is the expensive
+  //part, O(n h), so the points are split among the threads
+  vector<face_plane> planes(hull.size());
+  for (size_t f = 0; f < hull.size(); f++) planes[f] = make_plane(hull[f]);
+
+  vector<thread> workers;
+  vector<long> counts(nthreads, 0);
+  size_t chunk = (points.size() + nthreads - 1) / nthreads;
+  for (int t = 0; t < nthreads; t++) {
+    size_t lo = min(points.size(), t * chunk), hi = min(points.size(), lo + chunk);
+    workers.push_back(thread(count_outside, &points, &hull, &planes, lo, hi, &counts[t]));
+  }
+  for (int t = 0; t < nthreads; t++) {
+    workers[t].join();
+    cert.outside += counts[t];
+  }
+
+  if (cert.dim < 3) {
+    //flat inputs have no 3d hull; anything that does not cut off a
+    //point is accepted, including no faces at all
+    cert.ok = (cert.outside == 0);
+  } else {
+    cert.ok = (cert.nfaces > 0 && cert.degenerate_faces == 0 && cert.bad_edges == 0 &&
+               cert.reflex_edges == 0 && cert.outside == 0 &&
+               cert.nvertices - cert.nedges + cert.nfaces == 2);
+  }
+  return cert;
+}
+
+
+
+/* a face as its three corners, rotated so that the smallest corner
+   comes first; the rotation keeps the orientation */
+typedef struct _face_key {
+  point3d p[3];
+} face_key;
+
+static face_key make_key(triangle3d t) {
+
+  face_key k;
+  point3d c[3] = {*t.a, *t.b, *t.c};
+  int s = 0;
+  if (point_less(c[1], c[s])) s = 1;
+  if (point_less(c[2], c[s])) s = 2;
+  for (int i = 0; i < 3; i++) k.p[i] = c[(s+i)%3];
+  return k;
+}
+
+static bool key_less(const face_key &a, const face_key &b) {
+  for (int i = 0; i < 3; i++) {
+    if (point_less(a.p[i], b.p[i])) return true;
+    if (point_less(b.p[i], a.p[i])) return false;
+  }
+  return false;
+}
+
+
+int same_hull(vector<triangle3d> &h1, vector<triangle3d> &h2) {
+
+  if (h1.size() != h2.size()) return 0;
+
+  vector<face_key> k1, k2;
+  for (size_t i = 0; i < h1.size(); i++) k1.push_back(make_key(h1[i]));
+  for (size_t i = 0; i < h2.size(); i++) k2.push_back(make_key(h2[i]));
+  sort(k1.begin(), k1.end(), key_less);
+  sort(k2.begin(), k2.end(), key_less);
+
+  for (size_t i = 0; i < k1.size(); i++) {
+    if (key_less(k1[i], k2[i]) || key_less(k2[i], k1[i])) return 0;
+  }
+  return 1;
+}
+
+
+
+static void print_certificate(const char *name, const char *engine, int n,
+                              hull_certificate &c) {
+
+  printf("FAIL %s n=%d %s: dim=%d V=%d E=%d F=%d stray=%d flat=%d "
+         "bad_edges=%d reflex=%d outside=%ld\n",
+         name, n, engine, c.dim, c.nvertices, c.nedges, c.nfaces, c.stray_vertices,
+         c.degenerate_faces, c.bad_edges, c.reflex_edges, c.outside);
+}
+
+
+int check_engines(vector<point3d> &points, const char *name, int degenerate,
+                  int nthreads) {
+
+  int failures = 0;
+  int n = points.size();
+  hull_engine_entry &ref = hull_engines[0];
+
+  //the reference hull, when the reference engine can be trusted on
+  //this input
+  vector<triangle3d> expected;
+  int have_expected = 0;
+  if (!degenerate && (ref.max_n == 0 || n <= ref.max_n)) {
+    expected = ref.fn(points);
+    hull_certificate c = certify_hull(points, expected, nthreads);
+    if (!c.ok) {
+      print_certificate(name, ref.name, n, c);
+      failures++;
+    } else {
+      have_expected = 1;
+    }
+  }
+
+  for (int e = 1; hull_engines[e].name != NULL; e++) {
+    hull_engine_entry &engine = hull_engines[e];
+    if (engine.max_n > 0 && n > engine.max_n) continue;
+    if (degenerate && !engine.degenerate) continue;
+
+    vector<triangle3d> result = engine.fn(points);
+    hull_certificate c = certify_hull(points, result, nthreads);
+    if (!c.ok) {
+      print_certificate(name, engine.name, n, c);
+      failures++;
+    } else if (have_expected && !same_hull(result, expected)) {
+      printf("FAIL %s n=%d %s: %d faces, %s has %d\n", name, n, engine.name,
+             (int)result.size(), ref.name, (int)expected.size());
+      failures++;
+    }
+  }
+  return failures;
+}
+
+
+
+/* xorshift64*; the checks only need something fast and repeatable */
+static unsigned int next_random(unsigned long long *state) {
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return (unsigned int)((*state * 2685821657736338717ULL) >> 32);
+}
+
+/* a random int in [lo, hi) */
+static int random_in(unsigned long long *state, long long lo, long long hi) {
+  unsigned long long r = ((unsigned long long)next_random(state) << 32) | next_random(state);
+  return (int)(lo + (long long)(r % (unsigned long long)(hi - lo)));
+}
+
+static point3d make_point(int x, int y, int z) {
+  point3d p;
+  p.x = x; p.y = y; p.z = z;
+  return p;
+}
+
+
+/* what a reader thread of check_versioned_hull() saw */
+typedef struct _reader_log {
+  long queries;
+  int errors;
+} reader_log;
+
+/* query the hull until the writer is done. the hull only grows, so the
+   epochs seen must not go back, and a probe that was inside must stay
+   inside */
+static void query_versions(versioned_hull *vh, vector<point3d> *probes,
+                           atomic<int> *done, reader_log *log) {
+
+  int reader = versioned_hull_reader(vh);
+  vector<char> inside(probes->size(), 0);
+  unsigned long last = 0;
+  log->queries = log->errors = 0;
+  if (reader < 0) {
+    log->errors++;
+    return;
+  }
+  for (size_t i = 0; !done->load() || i < probes->size(); i++) {
+    size_t k = i % probes->size();
+    const hull_version *v = versioned_hull_enter(vh, reader);
+    int in = hull_version_contains(v, (*probes)[k]);
+    if (v->epoch < last || (inside[k] && !in)) log->errors++;
+    last = v->epoch;
+    inside[k] |= in;
+    versioned_hull_leave(vh, reader);
+    log->queries++;
+  }
+  versioned_hull_release(vh, reader);
+}
+
+
+int check_versioned_hull(unsigned int seed, int nthreads) {
+
+  unsigned long long state = 0x9E3779B97F4A7C15ULL ^ seed;
+  if (nthreads <= 0) nthreads = thread::hardware_concurrency();
+  if (nthreads <= 1) nthreads = 2;
+  int failures = 0;
+
+  //start flat so that the first versions have no faces, then add
+  //batches of growing spread, small ones and large ones
+  vector<point3d> points, probes;
+  for (int i = 0; i < 10; i++) {
+    points.push_back(make_point(random_in(&state, 0, 1000), random_in(&state, 0, 1000), 500));
+  }
+  for (int i = 0; i < 1000; i++) {
+    probes.push_back(make_point(random_in(&state, -2000, 3000), random_in(&state, -2000, 3000),
+                                random_in(&state, -2000, 3000)));
+  }
+
+  versioned_hull vh;
+  versioned_hull_init(&vh, points);
+  atomic<int> done(0);
+  vector<reader_log> logs(nthreads - 1);
+  vector<thread> readers;
+  for (int t = 0; t < nthreads - 1; t++) {
+    readers.push_back(thread(query_versions, &vh, &probes, &done, &logs[t]));
+  }
+
+  vector<point3d> batch;
+  for (int b = 0; b < 200; b++) {
+    batch.clear();
+    int spread = 1000 + 10 * b, size = (b % 10 == 0) ? 500 : random_in(&state, 1, 5);
+    for (int i = 0; i < size; i++) {
+      batch.push_back(make_point(random_in(&state, -spread, spread), random_in(&state, -spread, spread),
+                                 random_in(&state, -spread, spread)));
+    }
+    versioned_hull_insert(&vh, batch);
+    points.insert(points.end(), batch.begin(), batch.end());
+  }
+  done.store(1);
+  for (int t = 0; t < nthreads - 1; t++) {
+    readers[t].join();
+    if (logs[t].errors > 0) {
+      printf("FAIL versioned reader %d: %d errors in %ld queries\n", t,
+             logs[t].errors, logs[t].queries);
+      failures++;
+    }
+  }
+
+  //the last version must be the hull of everything inserted
+  //(its corners are copies, so they are appended to the points)
+  const hull_version *v = vh.current.load();
+  vector<point3d> all(points);
+  all.insert(all.end(), v->corner.begin(), v->corner.end());
+  vector<triangle3d> hull;
+  for (size_t f = points.size(); f < all.size(); f += 3) {
+    triangle3d t = {&all[f], &all[f+1], &all[f+2]};
+    hull.push_back(t);
+  }
+  hull_certificate cert = certify_hull(all, hull, nthreads);
+  if (!cert.ok || v->npoints != (long)points.size() || versioned_hull_reclaim(&vh) != 0) {
+    print_certificate("versioned", "incremental", points.size(), cert);
+    failures++;
+  }
+  versioned_hull_free(&vh);
+  return failures;
+}
+
+
+int check_hull_codec(unsigned int seed) {
+
+  unsigned long long state = 0x9E3779B97F4A7C15ULL ^ seed;
+  int failures = 0;
+  vector<point3d> points;
+  for (int i = 0; i < 2000; i++) {
+    points.push_back(make_point(random_in(&state, -1000, 1000), random_in(&state, -1000, 1000),
+                                random_in(&state, -1000, 1000)));
+  }
+  versioned_hull vh;
+  versioned_hull_init(&vh, points);
+
+  //a full hull, exact and quantized, and its truncations
+  hull_data sent, got;
+  hull_data_from_corners(vh.current.load()->corner, &sent);
+  vector<unsigned char> bytes;
+  long len = encode_hull(&sent, 0, bytes);
+  vector<triangle3d> t1, t2;
+  hull_data_triangles(&sent, t1);
+  if (decode_hull(bytes.data(), len, &got) == len) hull_data_triangles(&got, t2);
+  if (!same_hull(t1, t2)) {
+    printf("FAIL hull codec: decoded hull differs\n");
+    failures++;
+  }
+  for (long cut = 0; cut < len; cut += 1 + cut / 8) {
+    if (decode_hull(bytes.data(), cut, &got) != -1) {
+      printf("FAIL hull codec: decoded %ld of %ld bytes\n", cut, len);
+      failures++;
+      break;
+    }
+  }
+  bytes.clear();
+  len = encode_hull(&sent, 4, bytes);
+  if (decode_hull(bytes.data(), len, &got) != len || got.vertex.size() != sent.vertex.size() ||
+      got.face != sent.face) {
+    printf("FAIL hull codec: quantized hull\n");
+    failures++;
+  }
+  for (size_t v = 0; v < got.vertex.size() && failures == 0; v++) {
+    point3d &a = got.vertex[v], &b = sent.vertex[v];
+    if (abs(a.x - b.x) > 8 || abs(a.y - b.y) > 8 || abs(a.z - b.z) > 8) {
+      printf("FAIL hull codec: quantized vertex %d %d %d -> %d %d %d\n", b.x, b.y, b.z,
+             a.x, a.y, a.z);
+      failures++;
+    }
+  }
+
+  //a stream of diffs between versions, applied by a receiver
+  hull_data receiver = sent;
+  for (int b = 0; b < 50 && failures == 0; b++) {
+    vector<point3d> batch;
+    int spread = 1000 + 20 * b;
+    for (int i = random_in(&state, 1, 4); i > 0; i--) {
+      batch.push_back(make_point(random_in(&state, -spread, spread), random_in(&state, -spread, spread),
+                                 random_in(&state, -spread, spread)));
+    }
+    versioned_hull_insert(&vh, batch);
+    hull_data next;
+    hull_data_from_corners(vh.current.load()->corner, &next);
+
+    bytes.clear();
+    long full = encode_hull(&next, 0, bytes);
+    bytes.clear();
+    len = encode_hull_diff(&sent, &next, bytes);
+    if (len >= full) {
+      printf("FAIL hull codec: diff %d has %ld bytes, the hull %ld\n", b, len, full);
+      failures++;
+    }
+    hull_data other = next;
+    if (other.face.size() != sent.face.size() && apply_hull_diff(&other, bytes.data(), len) != -1) {
+      printf("FAIL hull codec: diff %d applied to the wrong hull\n", b);
+      failures++;
+    }
+    if (apply_hull_diff(&sent, bytes.data(), len) != len ||
+        apply_hull_diff(&receiver, bytes.data(), len) != len) {
+      printf("FAIL hull codec: diff %d rejected\n", b);
+      failures++;
+      break;
+    }
+    hull_data_triangles(&receiver, t1);
+    hull_data_triangles(&next, t2);
+    if (!same_hull(t1, t2) || receiver.vertex.size() != next.vertex.size()) {
+      printf("FAIL hull codec: diff %d gives %d faces, expected %d\n", b,
+             (int)t1.size(), (int)t2.size());
+      failures++;
+    }
+  }
+
+  //one more diff, applied to a hull with the same counts but a vertex
+  //moved, cut short, and with its removed vertices forged
+  if (failures == 0) {
+    vector<point3d> batch(1, make_point(2000, 2000, 2000));
+    versioned_hull_insert(&vh, batch);
+    hull_data next;
+    hull_data_from_corners(vh.current.load()->corner, &next);
+    bytes.clear();
+    len = encode_hull_diff(&sent, &next, bytes);
+    hull_data other = sent;
+    other.vertex[0].x--;
+    if (apply_hull_diff(&other, bytes.data(), len) != -1 || other.face != sent.face) {
+      printf("FAIL hull codec: diff applied to a hull with a moved vertex\n");
+      failures++;
+    }
+    for (long cut = 0; cut < len; cut += 1 + cut / 8) {
+      if (apply_hull_diff(&receiver, bytes.data(), cut) != -1 || receiver.face != sent.face) {
+        printf("FAIL hull codec: applied %ld of %ld bytes of a diff\n", cut, len);
+        failures++;
+        break;
+      }
+    }
+
+    //past the magic, V, F and the hash: the removed vertices, then no
+    //added vertices, removed faces or added faces. the first byte of
+    //each is its length
+    long head = 5;
+    for (int k = 0; k < 3; k++) {
+      while (bytes[head] & 0x80) head++;
+      head++;
+    }
+    static const unsigned char forged[4][13] = {
+      {1, 0},                                                           //none: valid
+      {12, 2, 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01},  //wraps to -1
+      {3, 2, 3, 0},                                                     //the same one twice
+      {5, 1, 0xFF, 0xFF, 0xFF, 0x7F},                                   //past the last vertex
+    };
+    for (int k = 0; k < 4; k++) {
+      vector<unsigned char> diff(bytes.begin(), bytes.begin() + head);
+      diff.insert(diff.end(), forged[k] + 1, forged[k] + 1 + forged[k][0]);
+      diff.insert(diff.end(), 3, 0);
+      other = sent;
+      long got_len = apply_hull_diff(&other, diff.data(), diff.size());
+      if (got_len != (k == 0 ? (long)diff.size() : -1) || other.face != sent.face) {
+        printf("FAIL hull codec: forged diff %d gives %ld\n", k, got_len);
+        failures++;
+      }
+    }
+  }
+  versioned_hull_free(&vh);
+  return failures;
+}
+
+
+/* the largest and smallest of n . p over the vertices of s */
+static void shape_extent(convex_shape &s, long long n[3], long long *lo, long long *hi) {
+  for (size_t v = 0; v < s.vertex.size(); v++) {
+    point3d &p = s.vertex[v];
+    long long h = n[0] * p.x + n[1] * p.y + n[2] * p.z;
+    if (v == 0 || h < *lo) *lo = h;
+    if (v == 0 || h > *hi) *hi = h;
+  }
+}
+
+/* 1 if some face normal of a or b, or cross product of an edge of a
+   and one of b, strictly separates them (exactly, in integers), and the
+   least overlap of a and b along those axes in overlap */
+static int separated(convex_shape &a, convex_shape &b, vector<triangle3d> &fa,
+                     vector<triangle3d> &fb, double *overlap) {
+
+  vector<long long> axes;
+  vector<triangle3d> *faces[2] = {&fa, &fb};
+  for (int s = 0; s < 2; s++) {
+    for (size_t f = 0; f < faces[s]->size(); f++) {
+      triangle3d &t = (*faces[s])[f];
+      long long u[3] = {t.b->x - t.a->x, t.b->y - t.a->y, t.b->z - t.a->z};
+      long long w[3] = {t.c->x - t.a->x, t.c->y - t.a->y, t.c->z - t.a->z};
+      axes.push_back(u[1]*w[2] - u[2]*w[1]);
+      axes.push_back(u[2]*w[0] - u[0]*w[2]);
+      axes.push_back(u[0]*w[1] - u[1]*w[0]);
+    }
+  }
+  for (size_t v = 0; v < a.vertex.size(); v++) {
+    for (int k = a.first[v]; k < a.first[v+1]; k++) {
+      if (a.adj[k] < (int)v) continue;
+      point3d &p = a.vertex[v], &q = a.vertex[a.adj[k]];
+      long long u[3] = {q.x - p.x, q.y - p.y, q.z - p.z};
+      for (size_t x = 0; x < b.vertex.size(); x++) {
+        for (int l = b.first[x]; l < b.first[x+1]; l++) {
+          if (b.adj[l] < (int)x) continue;
+          point3d &r = b.vertex[x], &t = b.vertex[b.adj[l]];
+          long long w[3] = {t.x - r.x, t.y - r.y, t.z - r.z};
+          axes.push_back(u[1]*w[2] - u[2]*w[1]);
+          axes.push_back(u[2]*w[0] - u[0]*w[2]);
+          axes.push_back(u[0]*w[1] - u[1]*w[0]);
+        }
+      }
+    }
+  }
+
+  int apart = 0;
+  *overlap = DBL_MAX;
+  for (size_t k = 0; k < axes.size(); k += 3) {
+    long long *n = &axes[k];
+    if (n[0] == 0 && n[1] == 0 && n[2] == 0) continue;
+    long long alo = 0, ahi = 0, blo = 0, bhi = 0;
+    shape_extent(a, n, &alo, &ahi);
+    shape_extent(b, n, &blo, &bhi);
+    if (ahi < blo || bhi < alo) apart = 1;
+    double len = sqrt((double)n[0]*n[0] + (double)n[1]*n[1] + (double)n[2]*n[2]);
+    *overlap = min(*overlap, min(ahi - blo, bhi - alo) / len);
+  }
+  return apart;
+}
+
+
+/* field by field, as the padding of hull_query is not set */
+static bool same_query(const hull_query &a, const hull_query &b) {
+  if (a.intersect != b.intersect || a.distance != b.distance || a.depth != b.depth ||
+      a.iterations != b.iterations) return false;
+  for (int i = 0; i < 3; i++) {
+    if (a.normal[i] != b.normal[i] || a.on_a[i] != b.on_a[i] || a.on_b[i] != b.on_b[i]) return false;
+  }
+  return true;
+}
+
+
+int check_gjk(unsigned int seed, int nthreads) {
+
+  unsigned long long state = 0x9E3779B97F4A7C15ULL ^ seed;
+  int failures = 0;
+
+  //small clouds, many of them overlapping
+  int nshapes = 30;
+  vector<vector<point3d> > clouds(nshapes);
+  vector<vector<triangle3d> > hulls(nshapes);
+  vector<convex_shape> shapes(nshapes);
+  for (int s = 0; s < nshapes; s++) {
+    int cx = random_in(&state, 0, 400), cy = random_in(&state, 0, 400),
+        cz = random_in(&state, 0, 400), r = random_in(&state, 5, 150);
+    int n = random_in(&state, 4, 40);
+    for (int i = 0; i < n; i++) {
+      clouds[s].push_back(make_point(cx + random_in(&state, -r, r), cy + random_in(&state, -r, r),
+                                     cz + random_in(&state, -r, r)));
+    }
+    hulls[s] = incremental_hull(clouds[s]);
+    convex_shape_from_faces(hulls[s], &shapes[s]);
+  }
+  vector<pair<int, int> > pairs;
+  for (int s = 0; s < nshapes; s++) {
+    for (int t = s+1; t < nshapes; t++) pairs.push_back(make_pair(s, t));
+  }
+  vector<hull_query> result;
+  hull_gjk_batch(shapes, pairs, 1, result, nthreads);
+
+  for (size_t k = 0; k < pairs.size(); k++) {
+    convex_shape &a = shapes[pairs[k].first], &b = shapes[pairs[k].second];
+    hull_query &q = result[k], single;
+    hull_gjk(&a, &b, 1, &single);
+    double overlap;
+    int apart = separated(a, b, hulls[pairs[k].first], hulls[pairs[k].second], &overlap);
+    double tol = 1e-3;    //the coordinates are below 1000
+    const char *error = NULL;
+
+    if (!same_query(q, single)) {
+      error = "batch differs";
+    } else if (q.intersect == apart && fabs(overlap) > tol) {
+      error = apart ? "missed the separation" : "missed the intersection";
+    } else if (!q.intersect) {
+      //the plane through on_a normal to normal must separate them,
+      //which proves that no two points are closer
+      double d[3] = {q.on_b[0] - q.on_a[0], q.on_b[1] - q.on_a[1], q.on_b[2] - q.on_a[2]};
+      double ha = -DBL_MAX, lb = DBL_MAX;
+      for (size_t v = 0; v < a.vertex.size(); v++) {
+        ha = max(ha, q.normal[0] * a.vertex[v].x + q.normal[1] * a.vertex[v].y +
+                     q.normal[2] * a.vertex[v].z);
+      }
+      for (size_t v = 0; v < b.vertex.size(); v++) {
+        lb = min(lb, q.normal[0] * b.vertex[v].x + q.normal[1] * b.vertex[v].y +
+                     q.normal[2] * b.vertex[v].z);
+      }
+      if (fabs(sqrt(d[0]*d[0] + d[1]*d[1] + d[2]*d[2]) - q.distance) > tol ||
+          fabs(lb - ha - q.distance) > tol) {
+        error = "distance not certified";
+      }
+    } else if (apart == 0 && fabs(q.depth - overlap) > tol) {
+      error = "wrong depth";
+    }
+
+    if (error) {
+      printf("FAIL gjk pair %d %d: %s (intersect %d, distance %g, depth %g; separated %d, overlap %g)\n",
+             pairs[k].first, pairs[k].second, error, q.intersect, q.distance, q.depth, apart,
+             overlap);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+
+int check_hull_lod(vector<point3d> &points, const char *name, int nthreads) {
+
+  int failures = 0;
+  vector<triangle3d> hull = incremental_hull(points);
+  vector<hull_level> levels;
+  build_hull_lod(hull, levels);
+
+  vector<triangle3d> last;
+  hull_data_triangles(&levels.back().hull, last);
+  if (!same_hull(last, hull)) {
+    printf("FAIL %s lod: the last level is not the hull\n", name);
+    failures++;
+  }
+  for (size_t l = 0; l + 1 < levels.size(); l++) {
+    hull_level &coarse = levels[l], &fine = levels[l+1];
+    vector<triangle3d> faces;
+    hull_data_triangles(&coarse.hull, faces);
+    hull_certificate c = certify_hull(coarse.hull.vertex, faces, nthreads);
+    if (!c.ok) {
+      print_certificate(name, "lod", coarse.hull.vertex.size(), c);
+      failures++;
+    }
+    if (coarse.hull.vertex.size() >= fine.hull.vertex.size() || coarse.error < fine.error) {
+      printf("FAIL %s lod: level %d has %d vertices and error %g, the next %d and %g\n", name,
+             (int)l, (int)coarse.hull.vertex.size(), coarse.error,
+             (int)fine.hull.vertex.size(), fine.error);
+      failures++;
+    }
+    //the next level must be inside
+    int outside = 0;
+    for (size_t v = 0; v < fine.hull.vertex.size(); v++) {
+      for (size_t f = 0; f < faces.size(); f++) {
+        if (volume_sign(*faces[f].a, *faces[f].b, *faces[f].c, fine.hull.vertex[v]) > 0) {
+          outside++;
+          break;
+        }
+      }
+    }
+    if (outside) {
+      printf("FAIL %s lod: %d vertices of level %d outside level %d\n", name, outside,
+             (int)l + 1, (int)l);
+      failures++;
+    }
+  }
+  return failures;
+}
+
+
+int check_compact_hull(vector<point3d> &points, const char *name) {
+
+  compact_hull c;
+  incremental_compact_hull(points, &c);
+  vector<triangle3d> expected = incremental_hull(points), faces;
+  compact_hull_triangles(points, &c, faces);
+  long nf = c.face.size() / 3;
+
+  const char *error = NULL;
+  if (!same_hull(faces, expected)) {
+    error = "differs from incremental_hull";
+  } else if (nf > 0 && nf != 2L * c.nvertices - 4) {
+    error = "F != 2V - 4";
+  } else if (c.face.capacity() != c.face.size() || faces.capacity() != faces.size()) {
+    error = "not sized exactly";
+  }
+  if (error) {
+    printf("FAIL %s n=%d compact hull: %s (%ld faces, %d vertices)\n", name,
+           (int)points.size(), error, nf, c.nvertices);
+    return 1;
+  }
+  return 0;
+}
+
+
+/* the name of the first field of m that differs from want by more
+   than tol relative to scale, or NULL */
+static const char *metrics_differ(hull_metrics *m, hull_metrics *want, double scale,
+                                  double tol) {
+
+  double s2 = scale * scale, v = fabs(want->volume) + 1;
+  if (fabs(m->volume - want->volume) > tol * v) return "volume";
+  if (fabs(m->area - want->area) > tol * (fabs(want->area) + 1)) return "area";
+  for (int i = 0; i < 3; i++) {
+    if (fabs(m->centroid[i] - want->centroid[i]) > tol * scale) return "centroid";
+    for (int j = 0; j < 3; j++) {
+      if (fabs(m->inertia[i][j] - want->inertia[i][j]) > tol * v * s2) return "inertia";
+    }
+  }
+  return NULL;
+}
+
+
+int check_hull_metrics(unsigned int seed, int nthreads) {
+
+  unsigned long long state = 0x9E3779B97F4A7C15ULL ^ seed;
+  int failures = 0;
+
+  for (int round = 0; round < 4; round++) {
+    int o[3], e[3];
+    for (int i = 0; i < 3; i++) {
+      o[i] = random_in(&state, -1000, 1000);
+      e[i] = random_in(&state, 1, 500);
+    }
+    double a = e[0], b = e[1], c = e[2];
+
+    //a box, with extra points on its faces that the hull ignores
+    vector<point3d> points;
+    for (int k = 0; k < 8; k++) {
+      points.push_back(make_point(o[0] + (k&1) * e[0], o[1] + ((k>>1)&1) * e[1],
+                                  o[2] + ((k>>2)&1) * e[2]));
+    }
+    for (int k = 0; k < 20; k++) {
+      int p[3] = {random_in(&state, 0, e[0] + 1), random_in(&state, 0, e[1] + 1),
+                  random_in(&state, 0, e[2] + 1)};
+      int axis = random_in(&state, 0, 3);
+      p[axis] = random_in(&state, 0, 2) * e[axis];
+      points.push_back(make_point(o[0] + p[0], o[1] + p[1], o[2] + p[2]));
+    }
+    hull_metrics want, m;
+    memset(&want, 0, sizeof(want));
+    want.volume = a * b * c;
+    want.area = 2 * (a*b + b*c + c*a);
+    for (int i = 0; i < 3; i++) want.centroid[i] = o[i] + e[i] / 2.0;
+    want.inertia[0][0] = want.volume * (b*b + c*c) / 12;
+    want.inertia[1][1] = want.volume * (a*a + c*c) / 12;
+    want.inertia[2][2] = want.volume * (a*a + b*b) / 12;
+    vector<triangle3d> hull = incremental_hull(points);
+    compute_hull_metrics(hull, &m, 1);
+    const char *error = metrics_differ(&m, &want, 500, 1e-9);
+    if (error) {
+      printf("FAIL box %dx%dx%d metrics: %s\n", e[0], e[1], e[2], error);
+      failures++;
+    }
+
+    //the corner tetrahedron o, o + a x, o + b y, o + c z. its second
+    //moments about o are V a^2 / 10 and V a b / 20
+    points.clear();
+    points.push_back(make_point(o[0], o[1], o[2]));
+    points.push_back(make_point(o[0] + e[0], o[1], o[2]));
+    points.push_back(make_point(o[0], o[1] + e[1], o[2]));
+    points.push_back(make_point(o[0], o[1], o[2] + e[2]));
+    memset(&want, 0, sizeof(want));
+    want.volume = a * b * c / 6;
+    want.area = (a*b + b*c + c*a + sqrt(a*a*b*b + b*b*c*c + c*c*a*a)) / 2;
+    double cov[3][3];
+    for (int i = 0; i < 3; i++) {
+      want.centroid[i] = o[i] + e[i] / 4.0;
+      for (int j = 0; j < 3; j++) {
+        cov[i][j] = want.volume * e[i] * e[j] * ((i == j) ? 1.0/10 - 1.0/16 : 1.0/20 - 1.0/16);
+      }
+    }
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < 3; j++) {
+        want.inertia[i][j] = ((i == j) ? cov[0][0] + cov[1][1] + cov[2][2] : 0) - cov[i][j];
+      }
+    }
+    hull = incremental_hull(points);
+    compute_hull_metrics(hull, &m, 1);
+    error = metrics_differ(&m, &want, 500, 1e-9);
+    if (error) {
+      printf("FAIL tetrahedron %dx%dx%d metrics: %s\n", e[0], e[1], e[2], error);
+      failures++;
+    }
+  }
+
+  //a hull large enough to be split over the threads gives the same
+  //metrics as one thread, up to the order of the sums
+  vector<point3d> points;
+  gen_params g = {30000, seed, 500, 0, 0};
+  generate_points("sphere", &g, points, nthreads);
+  vector<triangle3d> hull = incremental_hull(points);
+  hull_metrics one, many;
+  compute_hull_metrics(hull, &one, 1);
+  compute_hull_metrics(hull, &many, (nthreads > 0) ? nthreads : 4);
+  const char *error = metrics_differ(&many, &one, 500, 1e-9);
+  if (error || memcmp(one.bbox_min, many.bbox_min, sizeof(one.bbox_min)) ||
+      memcmp(one.bbox_max, many.bbox_max, sizeof(one.bbox_max))) {
+    printf("FAIL sphere n=%d metrics: %s depends on the threads\n", (int)points.size(),
+           error ? error : "bbox");
+    failures++;
+  }
+  return failures;
+}
+
+
+/* the largest distance of a point outside the box */
+static double outside_box(vector<point3d> &points, obb *box) {
+
+  double worst = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    double d[3] = {points[i].x - box->center[0], points[i].y - box->center[1],
+                   points[i].z - box->center[2]};
+    for (int k = 0; k < 3; k++) {
+      double s = d[0]*box->axis[k][0] + d[1]*box->axis[k][1] + d[2]*box->axis[k][2];
+      worst = max(worst, fabs(s) - box->half[k]);
+    }
+  }
+  return worst;
+}
+
+
+/* the smallest box over a grid of orientations, by brute force: the
+   first axis at n by n angles over the sphere, and the second turned
+   about it by n/2 angles over a quarter turn */
+static double grid_box_volume(vector<point3d> &points, hull_mesh *mesh, int n) {
+
+  double best = DBL_MAX;
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j <= n; j++) {
+      double a = M_PI * i / n, b = M_PI * j / n;
+      double u[3] = {sin(b) * cos(a), sin(b) * sin(a), cos(b)};
+      double p[3] = {cos(b) * cos(a), cos(b) * sin(a), -sin(b)}, q[3] = {-sin(a), cos(a), 0};
+      for (int k = 0; k < n/2; k++) {
+        double g = M_PI * k / n, axis[3][3];
+        for (int l = 0; l < 3; l++) {
+          axis[0][l] = u[l];
+          axis[1][l] = cos(g) * p[l] + sin(g) * q[l];
+          axis[2][l] = -sin(g) * p[l] + cos(g) * q[l];
+        }
+        double volume = 1;
+        for (int l = 0; l < 3; l++) {
+          double lo = DBL_MAX, hi = -DBL_MAX;
+          for (size_t v = 0; v < mesh->vert.size(); v++) {
+            point3d &x = points[mesh->vert[v]];
+            double s = axis[l][0] * x.x + axis[l][1] * x.y + axis[l][2] * x.z;
+            lo = min(lo, s);
+            hi = max(hi, s);
+          }
+          volume *= hi - lo;
+        }
+        best = min(best, volume);
+      }
+    }
+  }
+  return best;
+}
+
+
+int check_obb(vector<point3d> &points, const char *name, int nthreads) {
+
+  vector<triangle3d> hull = incremental_hull(points);
+  if (hull.size() == 0) return 0;
+  hull_mesh mesh;
+  hull_metrics m;
+  obb pca, sampled, exact;
+  build_hull_mesh(points, hull, &mesh);
+  compute_hull_metrics(hull, &m, 1);
+  obb_pca(points, &mesh, &m, &pca);
+  obb_sampled(points, &mesh, &m, 2, &sampled, nthreads);
+  obb_exact(points, &mesh, &m, &exact, nthreads);
+
+  //rounding in the projections, relative to the size of the box
+  double tol = 1e-9 * (pca.half[0] + pca.half[1] + pca.half[2] + 1);
+  const char *error = NULL;
+  if (outside_box(points, &pca) > tol) {
+    error = "a point is outside the PCA box";
+  } else if (outside_box(points, &sampled) > tol) {
+    error = "a point is outside the sampled box";
+  } else if (outside_box(points, &exact) > tol) {
+    error = "a point is outside the exact box";
+  } else if (sampled.volume > pca.volume * (1 + 1e-9)) {
+    error = "sampled box larger than the PCA box";
+  } else if (exact.volume > sampled.volume * (1 + 1e-9)) {
+    error = "exact box larger than the sampled box";
+  } else if (exact.volume < m.volume * (1 - 1e-9)) {
+    error = "box smaller than the hull";
+  }
+
+  //on small hulls, no orientation of a fine grid may give a smaller box
+  double grid = 0;
+  if (!error && mesh.vert.size() <= 40) {
+    grid = grid_box_volume(points, &mesh, max(16, (int)cbrt(4e6 / mesh.vert.size())));
+    if (exact.volume > grid * (1 + 1e-9)) error = "exact box larger than on a grid of orientations";
+  }
+  if (error) {
+    printf("FAIL %s n=%d obb: %s (volumes %g, %g and %g, grid %g)\n", name, (int)points.size(),
+           error, pca.volume, sampled.volume, exact.volume, grid);
+    return 1;
+  }
+  return 0;
+}
+
+
+/* step the kinetic hull by disp and compare it with a fresh hull */
+static int kinetic_step_ok(kinetic_hull *k, vector<point3d> &disp, const char *what,
+                           int nthreads) {
+
+  kinetic_hull_step(k, disp);
+  vector<point3d> &points = *k->points;
+  vector<triangle3d> expected = incremental_hull(points);
+  hull_certificate c = certify_hull(points, k->hull, nthreads);
+  if (!c.ok || !same_hull(k->hull, expected)) {
+    printf("FAIL kinetic n=%d %s: %s (%d flips, %d inserted, rebuilt %d)\n",
+           (int)points.size(), what, c.ok ? "differs from incremental_hull" : "not a hull",
+           k->flips, k->inserted, k->rebuilt);
+    return 1;
+  }
+  return 0;
+}
+
+
+int check_kinetic(unsigned int seed, int nthreads) {
+
+  unsigned long long state = 0x9E3779B97F4A7C15ULL ^ seed;
+  int failures = 0;
+  int n = 400;
+  vector<point3d> points, disp(n);
+  for (int i = 0; i < n; i++) {
+    points.push_back(make_point(random_in(&state, 0, 1<<20), random_in(&state, 0, 1<<20),
+                                random_in(&state, 0, 1<<20)));
+  }
+  kinetic_hull k;
+  kinetic_hull_init(&k, &points);
+
+  //jitter every point, a little and then a lot
+  for (int step = 0; step < 10; step++) {
+    int r = (step < 5) ? 100 : 20000;
+    for (int i = 0; i < n; i++) {
+      disp[i] = make_point(random_in(&state, -r, r + 1), random_in(&state, -r, r + 1),
+                           random_in(&state, -r, r + 1));
+    }
+    failures += kinetic_step_ok(&k, disp, "jitter", nthreads);
+  }
+
+  //only interior points move: no edge is looked at
+  for (int i = 0; i < n; i++) {
+    disp[i] = k.on_hull[i] ? make_point(0, 0, 0) :
+              make_point(random_in(&state, -1, 2), random_in(&state, -1, 2), random_in(&state, -1, 2));
+  }
+  failures += kinetic_step_ok(&k, disp, "interior", nthreads);
+  if (k.checked != 0 || k.flips != 0 || k.rebuilt) {
+    printf("FAIL kinetic n=%d interior: %d faces checked, %d flips, rebuilt %d\n", n,
+           k.checked, k.flips, k.rebuilt);
+    failures++;
+  }
+
+  //a hull vertex pulled into the middle folds its faces; with no flips
+  //allowed the hull must be rebuilt
+  for (int i = 0; i < n; i++) disp[i] = make_point(0, 0, 0);
+  int v = k.mesh.vert[k.mesh.face[0]];
+  for (size_t f = 0; k.mesh.face[3*f] == DEAD_FACE; f++) v = k.mesh.vert[k.mesh.face[3*f+3]];
+  disp[v] = make_point(k.center.x - points[v].x, k.center.y - points[v].y,
+                       k.center.z - points[v].z);
+  int max_flips = k.max_flips;
+  k.max_flips = 0;
+  failures += kinetic_step_ok(&k, disp, "rebuild", nthreads);
+  k.max_flips = max_flips;
+  if (!k.rebuilt) {
+    printf("FAIL kinetic n=%d: a folded hull was not rebuilt\n", n);
+    failures++;
+  }
+  return failures;
+}
+
+
+int check_dedup(vector<point3d> &points, const char *name, int grid, int nthreads) {
+
+  int n = points.size();
+  dedup_table one, many;
+  long m = dedup_points(points, grid, &one, 1);
+  dedup_points(points, grid, &many, (nthreads > 0) ? nthreads : 4);
+
+  const char *error = NULL;
+  if (m != (long)one.points.size() || one.first.size() != one.points.size() ||
+      (int)one.remap.size() != n) {
+    error = "table sizes";
+  } else if (one.remap != many.remap || one.first != many.first) {
+    error = "depends on the threads";
+  }
+  int half = max(grid, 1) / 2;
+  for (int i = 0; i < n && !error; i++) {
+    int u = one.remap[i];
+    point3d &p = points[i], &q = one.points[u];
+    if (u < 0 || u >= m || one.first[u] > i) {
+      error = "remap";
+    } else if (abs(p.x - q.x) > half || abs(p.y - q.y) > half || abs(p.z - q.z) > half) {
+      error = "snapped too far";
+    }
+  }
+  for (long u = 0; u < m && !error; u++) {
+    if (one.remap[one.first[u]] != u || (u > 0 && one.first[u-1] >= one.first[u])) {
+      error = "first";
+    }
+  }
+  if (!error) {
+    vector<point3d> sorted(one.points);
+    sort(sorted.begin(), sorted.end(), point_less);
+    for (long u = 1; u < m && !error; u++) {
+      if (isEqual(sorted[u-1], sorted[u])) error = "repeated point";
+    }
+  }
+
+  if (error) {
+    printf("FAIL %s n=%d dedup grid=%d: %s\n", name, n, grid, error);
+    return 1;
+  }
+  return 0;
+}
+
+
+/* p is strictly inside the circle through the counterclockwise abc:
+   the lifted determinant, exactly */
+static int in_circle(point2d a, point2d b, point2d c, point2d p) {
+  long long adx = (long long)a.x - p.x, ady = (long long)a.y - p.y;
+  long long bdx = (long long)b.x - p.x, bdy = (long long)b.y - p.y;
+  long long cdx = (long long)c.x - p.x, cdy = (long long)c.y - p.y;
+  __int128 det = (__int128)(adx*adx + ady*ady) * (bdx*cdy - cdx*bdy) +
+                 (__int128)(bdx*bdx + bdy*bdy) * (cdx*ady - adx*cdy) +
+                 (__int128)(cdx*cdx + cdy*cdy) * (adx*bdy - bdx*ady);
+  return det > 0;
+}
+
+static bool point2d_less(const point2d &a, const point2d &b) {
+  return (a.x != b.x) ? a.x < b.x : a.y < b.y;
+}
+
+/* twice the area of the 2d convex hull of the points */
+static long long hull_area2(vector<point2d> points) {
+
+  sort(points.begin(), points.end(), point2d_less);
+  int n = points.size(), k = 0;
+  if (n < 3) return 0;
+  vector<point2d> h(2 * n);
+  for (int i = 0; i < n; i++) {
+    while (k >= 2 && orient2d(h[k-2], h[k-1], points[i]) <= 0) k--;
+    h[k++] = points[i];
+  }
+  for (int i = n - 2, low = k + 1; i >= 0; i--) {
+    while (k >= low && orient2d(h[k-2], h[k-1], points[i]) <= 0) k--;
+    h[k++] = points[i];
+  }
+  long long area = 0;
+  for (int i = 1; i + 2 < k; i++) area += orient2d(h[0], h[i], h[i+1]);
+  return area;
+}
+
+/* what is wrong with tri as the Delaunay triangulation of points and
+   with its Voronoi diagram, or NULL */
+static const char *delaunay_error(vector<point2d> &points, vector<int> &tri, int ntri) {
+
+  int n = points.size();
+  if (ntri != (int)tri.size() / 3) return "triangle count";
+
+  //counterclockwise, and no edge twice the same way
+  long long area = 0;
+  vector<pair<int, int> > edges;
+  vector<char> used(n, 0);
+  for (int t = 0; t < ntri; t++) {
+    int *v = &tri[3*t];
+    long long o = orient2d(points[v[0]], points[v[1]], points[v[2]]);
+    if (o <= 0) return "not counterclockwise";
+    area += o;
+    for (int i = 0; i < 3; i++) {
+      edges.push_back(make_pair(v[i], v[(i+1)%3]));
+      used[v[i]] = 1;
+    }
+  }
+  sort(edges.begin(), edges.end());
+  if (adjacent_find(edges.begin(), edges.end()) != edges.end()) return "overlapping triangles";
+  if (area != hull_area2(points)) return "does not cover the hull";
+
+  //empty circles, and every distinct point used
+  for (int i = 0; i < n; i++) {
+    for (int t = 0; t < ntri; t++) {
+      int *v = &tri[3*t];
+      if (in_circle(points[v[0]], points[v[1]], points[v[2]], points[i])) {
+        return "point inside a circumcircle";
+      }
+    }
+  }
+  for (int i = 0; i < n && ntri > 0; i++) {
+    if (used[i]) continue;
+    int j = 0;
+    while (j < n && !(used[j] && points[j].x == points[i].x && points[j].y == points[i].y)) j++;
+    if (j == n) return "point left out";
+  }
+
+  //one Voronoi edge per Delaunay edge, a ray per hull edge, and the
+  //vertices at the centers of the circles
+  voronoi vor;
+  voronoi_from_delaunay(points, tri, &vor);
+  int undirected = 0, rays = 0;
+  for (size_t k = 0; k < edges.size(); k++) {
+    pair<int, int> back(edges[k].second, edges[k].first);
+    if (!binary_search(edges.begin(), edges.end(), back)) {
+      undirected++;
+      rays++;
+    } else if (edges[k].first < edges[k].second) {
+      undirected++;
+    }
+  }
+  int vrays = 0;
+  for (size_t k = 0; k < vor.edge.size(); k++) vrays += (vor.edge[k].vertex[1] < 0);
+  if ((int)vor.edge.size() != undirected || vrays != rays) return "voronoi edge count";
+  for (int t = 0; t < ntri; t++) {
+    double d[3];
+    for (int i = 0; i < 3; i++) {
+      point2d &p = points[tri[3*t+i]];
+      d[i] = hypot(vor.vertex[2*t] - p.x, vor.vertex[2*t+1] - p.y);
+    }
+    if (fabs(d[0] - d[1]) > 1e-6 * d[0] || fabs(d[0] - d[2]) > 1e-6 * d[0]) {
+      return "voronoi vertex off the circumcenter";
+    }
+  }
+  return NULL;
+}
+
+
+int check_delaunay(unsigned int seed) {
+
+  unsigned long long state = 0x9E3779B97F4A7C15ULL ^ seed;
+  int failures = 0;
+  const char *sets[] = {"random", "small_grid", "collinear", "wide", "too_wide"};
+  for (int round = 0; round < 4; round++) {
+    for (int s = 0; s < 5; s++) {
+      vector<point2d> points;
+      int n = random_in(&state, 1, 300);
+      for (int i = 0; i < n; i++) {
+        point2d p;
+        if (s == 0) {
+          p.x = random_in(&state, 0, 1000);
+          p.y = random_in(&state, 0, 1000);
+        } else if (s == 1) {
+          //cocircular, collinear and repeated points
+          p.x = random_in(&state, 0, 6);
+          p.y = random_in(&state, 0, 6);
+        } else if (s == 2) {
+          p.x = random_in(&state, -1000, 1000);
+          p.y = 3 * p.x - 5;
+        } else {
+          //the widest range that still lifts, off the origin, and one
+          //more
+          int span = 2 * LIFT_MAX + (s == 4);
+          p.x = 1000000 + random_in(&state, 0, span + 1);
+          p.y = -1000000 + random_in(&state, 0, span + 1);
+          if (i < 2) p.x = 1000000 + i * span;
+        }
+        points.push_back(p);
+      }
+
+      vector<int> tri;
+      int ntri = delaunay_triangulation(points, tri);
+      const char *error = NULL;
+      if (s == 4) {
+        if (n >= 3 && ntri != -1) error = "range not refused";
+      } else if (ntri < 0) {
+        error = "refused";
+      } else {
+        error = delaunay_error(points, tri, ntri);
+      }
+      if (error) {
+        printf("FAIL %s n=%d delaunay: %s (%d triangles)\n", sets[s], n, error, ntri);
+        failures++;
+      }
+    }
+  }
+  return failures;
+}
+
+
+int run_hull_checks(unsigned int seed, int trials, int nthreads) {
+
+  unsigned long long state = 0x9E3779B97F4A7C15ULL ^ seed;
+  int failures = 0;
+  vector<point3d> points;
+
+  for (int t = 0; t < trials; t++) {
+
+    //random points in general position
+    points.clear();
+    int n = random_in(&state, 4, 40);
+    for (int i = 0; i < n; i++) {
+      points.push_back(make_point(random_in(&state, 0, 1<<20), random_in(&state, 0, 1<<20),
+                                  random_in(&state, 0, 1<<20)));
+    }
+    failures += check_engines(points, "random", 0, nthreads);
+    failures += check_obb(points, "random", nthreads);
+
+    //large coordinates, where signed_volume() used to overflow
+    points.clear();
+    for (int i = 0; i < n; i++) {
+      points.push_back(make_point(random_in(&state, -(1<<30), 1<<30),
+                                  random_in(&state, -(1<<30), 1<<30),
+                                  random_in(&state, -(1<<30), 1<<30)));
+    }
+    failures += check_engines(points, "large_coords", 0, nthreads);
+    failures += check_dedup(points, "large_coords", 1, nthreads);
+
+    //a small grid: many coplanar, collinear and duplicated points
+    points.clear();
+    for (int i = 0; i < n; i++) {
+      points.push_back(make_point(random_in(&state, 0, 4), random_in(&state, 0, 4),
+                                  random_in(&state, 0, 4)));
+    }
+    failures += check_engines(points, "small_grid", 1, nthreads);
+
+    //all points on one plane
+    points.clear();
+    for (int i = 0; i < n; i++) {
+      int u = random_in(&state, -1000, 1000), v = random_in(&state, -1000, 1000);
+      points.push_back(make_point(u, v, 3*u - 2*v + 7));
+    }
+    failures += check_engines(points, "coplanar", 1, nthreads);
+
+    //all points on one line
+    points.clear();
+    for (int i = 0; i < n; i++) {
+      int u = random_in(&state, -1000, 1000);
+      points.push_back(make_point(u, 2*u + 1, -3*u));
+    }
+    failures += check_engines(points, "collinear", 1, nthreads);
+
+    //a cube with extra points on its faces and edges
+    points.clear();
+    for (int i = 0; i < 8; i++) {
+      points.push_back(make_point((i&1) * 100, ((i>>1)&1) * 100, ((i>>2)&1) * 100));
+    }
+    for (int i = 8; i < n; i++) {
+      int c[3] = {random_in(&state, 0, 101), random_in(&state, 0, 101), random_in(&state, 0, 101)};
+      c[random_in(&state, 0, 3)] = 100 * random_in(&state, 0, 2);
+      points.push_back(make_point(c[0], c[1], c[2]));
+    }
+    failures += check_engines(points, "cube_faces", 1, nthreads);
+    failures += check_obb(points, "cube_faces", nthreads);
+
+    //a regular tetrahedron, turned: its smallest box is the cube it is
+    //inscribed in, flush with its edges but with none of its faces
+    points.clear();
+    double w = random_in(&state, -1000, 1001), x = random_in(&state, -1000, 1001),
+           y = random_in(&state, -1000, 1001), z = random_in(&state, -1000, 1001);
+    double len = sqrt(w*w + x*x + y*y + z*z) + 1e-300;
+    w /= len;
+    x /= len;
+    y /= len;
+    z /= len;
+    double turn[3][3] = {{1 - 2*(y*y + z*z), 2*(x*y - w*z), 2*(x*z + w*y)},
+                         {2*(x*y + w*z), 1 - 2*(x*x + z*z), 2*(y*z - w*x)},
+                         {2*(x*z - w*y), 2*(y*z + w*x), 1 - 2*(x*x + y*y)}};
+    for (int i = 0; i < 4; i++) {
+      double c[3] = {1000.0 * (i == 0 || i == 1 ? 1 : -1), 1000.0 * (i == 0 || i == 2 ? 1 : -1),
+                     1000.0 * (i == 0 || i == 3 ? 1 : -1)}, r[3];
+      for (int k = 0; k < 3; k++) r[k] = turn[k][0] * c[0] + turn[k][1] * c[1] + turn[k][2] * c[2];
+      points.push_back(make_point(lround(r[0]), lround(r[1]), lround(r[2])));
+    }
+    failures += check_obb(points, "tetrahedron", nthreads);
+
+    //every point repeated a few times, in random order
+    points.clear();
+    for (int i = 0; i < n/3 + 1; i++) {
+      point3d p = make_point(random_in(&state, 0, 500), random_in(&state, 0, 500),
+                             random_in(&state, 0, 500));
+      for (int k = random_in(&state, 1, 4); k > 0; k--) points.push_back(p);
+    }
+    for (size_t i = points.size(); i > 1; i--) {
+      swap(points[i-1], points[random_in(&state, 0, i)]);
+    }
+    failures += check_engines(points, "duplicates", 1, nthreads);
+    failures += check_dedup(points, "duplicates", 1, nthreads);
+
+    //an octahedron with all the other points at its center, like
+    //beautiful_diamond()
+    points.clear();
+    points.push_back(make_point(0, 200, 0));
+    points.push_back(make_point(0, 100, 0));
+    points.push_back(make_point(50, 150, 50));
+    points.push_back(make_point(-50, 150, 50));
+    points.push_back(make_point(50, 150, -50));
+    points.push_back(make_point(-50, 150, -50));
+    for (int i = 6; i < n; i++) points.push_back(make_point(0, 150, 0));
+    failures += check_engines(points, "diamond", 1, nthreads);
+
+    //many points, only for the engines that scale
+    points.clear();
+    n = random_in(&state, 10000, 50000);
+    for (int i = 0; i < n; i++) {
+      points.push_back(make_point(random_in(&state, 0, 1<<16), random_in(&state, 0, 1<<16),
+                                  random_in(&state, 0, 1<<16)));
+    }
+    failures += check_engines(points, "large_n", 1, nthreads);
+    failures += check_dedup(points, "large_n", 1, nthreads);
+    failures += check_dedup(points, "large_n", 1 + random_in(&state, 1, 1000), nthreads);
+  }
+
+  //every point set of the viewer and the generators, at a few sizes
+  long sizes[] = {10, 30, 2000};
+  for (int s = 0; s < 3; s++) {
+    for (int k = 0; point_generators[k].name; k++) {
+      gen_params g = {sizes[s], seed, 500, 0, 0};
+      generate_points(point_generators[k].name, &g, points, nthreads);
+      failures += check_engines(points, point_generators[k].name, 1, nthreads);
+      failures += check_compact_hull(points, point_generators[k].name);
+      if (sizes[s] < 1000) failures += check_obb(points, point_generators[k].name, nthreads);
+    }
+  }
+
+  failures += check_hull_metrics(seed, nthreads);
+  failures += check_kinetic(seed, nthreads);
+  failures += check_versioned_hull(seed, nthreads);
+  failures += check_hull_codec(seed);
+  const char *lod_sets[] = {"sphere", "ball", "clusters"};
+  for (int s = 0; s < 3; s++) {
+    gen_params g = {20000, seed, 500, 0, 0};
+    generate_points(lod_sets[s], &g, points, nthreads);
+    failures += check_hull_lod(points, lod_sets[s], nthreads);
+  }
+  failures += check_gjk(seed, nthreads);
+  failures += check_delaunay(seed);
+
+  printf("hull checks: %d trials, seed %u, %d failures\n", trials, seed, failures);
+  return failures;
+}
@@ -0,0 +1,138 @@
+#ifndef __hullcheck_h
+#define __hullcheck_h
+
+#include "geom.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* every hull engine has the same signature as brute_force_hull(): the
+   faces it returns point into the vector that was passed in */
+typedef vector<triangle3d> (*hull_engine)(vector<point3d> &points);
+
+typedef struct _hull_engine_entry {
+  const char *name;
+  hull_engine fn;
+  int degenerate;  //1 if the engine handles coplanar, collinear and duplicate points
+  int max_n;       //largest input the engine is run on; 0 means no limit
+} hull_engine_entry;
+
+/* the engines exercised by check_engines(), terminated by an entry
+   with a NULL name. the first entry is the reference the others are
+   compared against on small inputs */
+extern hull_engine_entry hull_engines[];
+
+
+/* what certify_hull() found out about a hull */
+typedef struct _hull_certificate {
+  int dim;               //affine dimension of the input points (0..3)
+  int nvertices, nedges, nfaces;
+  int stray_vertices;    //face corners that do not point into the input
+  int degenerate_faces;  //faces with zero area
+  int bad_edges;         //directed edges without exactly one reversed twin
+  int reflex_edges;      //edges where the neighbouring face bends outward
+  long outside;          //(point, face) pairs with the point strictly outside
+  int ok;
+} hull_certificate;
+
+
+/* checks that hull is the convex hull of points: a closed, consistently
+   oriented triangulated surface with V - E + F = 2, convex at every
+   edge, and with every point inside or on every face. the containment
+   test is split over nthreads threads (0 means one per core) */
+hull_certificate certify_hull(vector<point3d> &points, vector<triangle3d> &hull,
+                              int nthreads);
+
+/* return 1 if the two hulls have the same oriented faces, in any order
+   and starting at any corner; 0 otherwise */
+int same_hull(vector<triangle3d> &h1, vector<triangle3d> &h2);
+
+/* run every engine in hull_engines[] on points, certify the result and
+   compare it against the reference engine when the input is small
+   enough. engines that do not handle degenerate inputs are skipped when
+   degenerate is set. prints one line per failure and returns the
+   number of failures */
+int check_engines(vector<point3d> &points, const char *name, int degenerate,
+                  int nthreads);
+
+/* grow a versioned hull (hullversion.h) in batches while nthreads - 1
+   reader threads query it, and check that no reader sees the hull
+   shrink or go back a version, and that the last version is the hull
+   of every point inserted. returns the number of failures */
+int check_versioned_hull(unsigned int seed, int nthreads);
+
+/* encode and decode a hull with hullcodec.h, whole, quantized and
+   truncated, then grow it in small batches and check that a receiver
+   applying the diffs between versions keeps the same hull. returns the
+   number of failures */
+int check_hull_codec(unsigned int seed);
+
+/* run hull_gjk_batch() (gjk.h) on every pair of a few dozen random
+   hulls, and check each answer against hull_gjk() alone and against
+   the separating axes of the pair: the intersection test exactly, the
+   distance by the plane through the closest points, and the depth by
+   the least overlap along the axes. returns the number of failures */
+int check_gjk(unsigned int seed, int nthreads);
+
+/* build the levels of detail (lod.h) of the hull of the points and
+   check that each one is a convex hull with fewer vertices and more
+   error than the next, contains the next, and that the last one is
+   the hull. returns the number of failures */
+int check_hull_lod(vector<point3d> &points, const char *name, int nthreads);
+
+/* compute the hull of the points as a compact_hull (compacthull.h)
+   and check that it is the incremental hull, has F = 2V - 4 faces and
+   was allocated at its exact size. returns the number of failures */
+int check_compact_hull(vector<point3d> &points, const char *name);
+
+/* compare compute_hull_metrics() (hullmetrics.h) on boxes and corner
+   tetrahedra with their volume, area, centroid and inertia in closed
+   form, and on a large hull with one thread and with nthreads. returns
+   the number of failures */
+int check_hull_metrics(unsigned int seed, int nthreads);
+
+/* fit obb_pca(), obb_sampled() and obb_exact() (obb.h) on the hull of
+   the points and check that every box contains every point, that each
+   is no larger than the one before, and that the exact box is not
+   smaller than the hull. on hulls of at most 40 vertices the exact box
+   must also be no larger than the smallest over a fine grid of
+   orientations. returns the number of failures */
+int check_obb(vector<point3d> &points, const char *name, int nthreads);
+
+/* move random points with kinetic_hull_step() (kinetic.h), by small
+   and large steps, and check the kinetic hull against a fresh
+   incremental hull after each one. also checks that a step moving only
+   interior points looks at no edge, and that a hull folded by a step
+   is rebuilt. returns the number of failures */
+int check_kinetic(unsigned int seed, int nthreads);
+
+/* remove the repeated points of points with dedup_points() (dedup.h),
+   snapping to grid, with one thread and with nthreads, and check that
+   both give the same table, that the distinct points are distinct and
+   in input order, and that each input point maps to one within grid/2.
+   returns the number of failures */
+int check_dedup(vector<point3d> &points, const char *name, int grid, int nthreads);
+
+/* triangulate random, small grid (cocircular and repeated), collinear
+   and widest-range point sets in the plane with delaunay.h, and check
+   every triangle counterclockwise and with no point inside its circle,
+   exactly, the triangles covering the 2d hull once, and the Voronoi
+   diagram dual to them. returns the number of failures */
+int check_delaunay(unsigned int seed);
+
+/* generate trials rounds of random and adversarial inputs from seed
+   (random, coplanar, collinear, duplicated, large coordinates, large
+   n) and run check_engines() on each, then on every set of
+   point_generators[] (pointgen.h), check_hull_metrics(),
+   check_kinetic(), check_versioned_hull(), check_hull_codec(),
+   check_gjk(), check_hull_lod() and check_delaunay(), with
+   check_dedup() on some of them, check_obb() on the small ones and
+   check_compact_hull() on the generated sets.
+   returns the number of failures */
+int run_hull_checks(unsigned int seed, int trials, int nthreads);
+
+#endif
@@ -0,0 +1,457 @@
+/*  hullcodec.cpp
+ *
+ *  a compact binary form for hulls, and diffs between two hulls.
+ *
+ *  every number is written as a varint: 7 bits per byte, low bits
+ *  first, the high bit set on all bytes but the last. signed numbers
+ *  are zigzag encoded first (0, -1, 1, -2, ... become 0, 1, 2, 3, ...).
+ *  vertices are sorted, so the differences between consecutive
+ *  coordinates are small, and so are the differences between the
+ *  indices of a face and those of the previous face.
+ *
+ *  hull:  'H' '3' 'D' 'H' version quant_bits
+ *         V, then dx dy dz per vertex
+ *         F, then da, b - a, c - a per face
+ *  diff:  'H' '3' 'D' 'D' version
+ *         V and F of the old hull, and its hash
+ *         removed vertices (count, then index differences)
+ *         added vertices (count, then dx dy dz)
+ *         removed faces (count, then index differences)
+ *         added faces (count, then da, b - a, c - a)
+ *
+ */
+
+
+#include "hullcodec.h"
+#include <limits.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+
+#define CODEC_VERSION 2
+
+
+/* a face as vertex indices, starting at the smallest one; the rotation
+   keeps the orientation */
+typedef struct _index_face {
+  int v[3];
+  int id;    //where it came from
+} index_face;
+
+static index_face make_face(int a, int b, int c, int id) {
+  index_face f;
+  int s[3] = {a, b, c}, k = 0;
+  if (s[1] < s[k]) k = 1;
+  if (s[2] < s[k]) k = 2;
+  for (int i = 0; i < 3; i++) f.v[i] = s[(k+i)%3];
+  f.id = id;
+  return f;
+}
+
+static bool face_less(const index_face &a, const index_face &b) {
+  for (int i = 0; i < 3; i++) {
+    if (a.v[i] != b.v[i]) return a.v[i] < b.v[i];
+  }
+  return false;
+}
+
+static bool point_less(const point3d &a, const point3d &b) {
+  if (a.x != b.x) return a.x < b.x;
+  if (a.y != b.y) return a.y < b.y;
+  return a.z < b.z;
+}
+
+
+void hull_data_from_corners(const vector<point3d> &corner, hull_data *out) {
+
+  out->vertex.assign(corner.begin(), corner.end());
+  sort(out->vertex.begin(), out->vertex.end(), point_less);
+  out->vertex.erase(unique(out->vertex.begin(), out->vertex.end(), isEqual), out->vertex.end());
+
+  vector<index_face> faces;
+  for (size_t k = 0; k + 2 < corner.size(); k += 3) {
+    int v[3];
+    for (int i = 0; i < 3; i++) {
+      v[i] = lower_bound(out->vertex.begin(), out->vertex.end(), corner[k+i], point_less) -
+             out->vertex.begin();
+    }
+    faces.push_back(make_face(v[0], v[1], v[2], k / 3));
+  }
+  sort(faces.begin(), faces.end(), face_less);
+
+  out->face.clear();
+  for (size_t f = 0; f < faces.size(); f++) {
+    out->face.insert(out->face.end(), faces[f].v, faces[f].v + 3);
+  }
+}
+
+
+void hull_data_from_faces(vector<triangle3d> &faces, hull_data *out) {
+
+  vector<point3d> corner;
+  corner.reserve(3 * faces.size());
+  for (size_t f = 0; f < faces.size(); f++) {
+    corner.push_back(*faces[f].a);
+    corner.push_back(*faces[f].b);
+    corner.push_back(*faces[f].c);
+  }
+  hull_data_from_corners(corner, out);
+}
+
+
+/* FNV-1a over the bytes of the coordinates and the face indices, so
+   that a diff is only applied to the hull it was made from */
+static unsigned long long hull_hash(hull_data *data) {
+
+  unsigned long long h = 0xCBF29CE484222325ULL;
+  vector<unsigned int> words;
+  for (size_t v = 0; v < data->vertex.size(); v++) {
+    words.push_back(data->vertex[v].x);
+    words.push_back(data->vertex[v].y);
+    words.push_back(data->vertex[v].z);
+  }
+  words.insert(words.end(), data->face.begin(), data->face.end());
+  for (size_t k = 0; k < words.size(); k++) {
+    for (int b = 0; b < 32; b += 8) h = (h ^ ((words[k] >> b) & 0xFF)) * 0x100000001B3ULL;
+  }
+  return h;
+}
+
+
+void hull_data_triangles(hull_data *data, vector<triangle3d> &faces) {
+
+  faces.clear();
+  for (size_t k = 0; k + 2 < data->face.size(); k += 3) {
+    triangle3d t = {&data->vertex[data->face[k]], &data->vertex[data->face[k+1]],
+                    &data->vertex[data->face[k+2]]};
+    faces.push_back(t);
+  }
+}
+
+
+/* writing */
+
+static void put_varint(vector<unsigned char> &out, unsigned long long v) {
+  while (v >= 0x80) {
+    out.push_back((unsigned char)(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back((unsigned char)v);
+}
+
+static void put_signed(vector<unsigned char> &out, long long v) {
+  put_varint(out, ((unsigned long long)v << 1) ^ (unsigned long long)(v >> 63));
+}
+
+static void put_magic(vector<unsigned char> &out, char kind) {
+  const char magic[4] = {'H', '3', 'D', kind};
+  out.insert(out.end(), magic, magic + 4);
+  out.push_back(CODEC_VERSION);
+}
+
+/* the vertices, as differences to the previous one */
+static void put_vertices(vector<unsigned char> &out, const vector<point3d> &vertex,
+                         int quant_bits) {
+
+  put_varint(out, vertex.size());
+  long long prev[3] = {0, 0, 0};
+  for (size_t v = 0; v < vertex.size(); v++) {
+    long long c[3] = {vertex[v].x >> quant_bits, vertex[v].y >> quant_bits,
+                      vertex[v].z >> quant_bits};
+    for (int i = 0; i < 3; i++) {
+      put_signed(out, c[i] - prev[i]);
+      prev[i] = c[i];
+    }
+  }
+}
+
+/* the faces, 3 indices each */
+static void put_faces(vector<unsigned char> &out, const vector<int> &face) {
+
+  put_varint(out, face.size() / 3);
+  long long prev = 0;
+  for (size_t k = 0; k + 2 < face.size(); k += 3) {
+    put_signed(out, face[k] - prev);
+    put_signed(out, face[k+1] - face[k]);
+    put_signed(out, face[k+2] - face[k]);
+    prev = face[k];
+  }
+}
+
+/* an ascending list of indices */
+static void put_indices(vector<unsigned char> &out, const vector<int> &ids) {
+
+  put_varint(out, ids.size());
+  int prev = 0;
+  for (size_t i = 0; i < ids.size(); i++) {
+    put_varint(out, ids[i] - prev);
+    prev = ids[i];
+  }
+}
+
+
+long encode_hull(hull_data *data, int quant_bits, vector<unsigned char> &out) {
+
+  size_t start = out.size();
+  quant_bits = max(0, min(quant_bits, 30));
+  put_magic(out, 'H');
+  out.push_back(quant_bits);
+  put_vertices(out, data->vertex, quant_bits);
+  put_faces(out, data->face);
+  return out.size() - start;
+}
+
+
+/* reading. every get sets bad instead of reading past the end */
+
+typedef struct _byte_reader {
+  const unsigned char *in;
+  long len, pos;
+  int bad;
+} byte_reader;
+
+static unsigned long long get_varint(byte_reader *r) {
+
+  unsigned long long v = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (r->pos >= r->len) break;
+    unsigned char b = r->in[r->pos++];
+    v |= (unsigned long long)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return v;
+  }
+  r->bad = 1;
+  return 0;
+}
+
+static long long get_signed(byte_reader *r) {
+  unsigned long long z = get_varint(r);
+  return (long long)(z >> 1) ^ -(long long)(z & 1);
+}
+
+/* a count of items of at least size bytes each, which must fit in
+   what is left */
+static long get_count(byte_reader *r, int size) {
+  unsigned long long n = get_varint(r);
+  if (n > (unsigned long long)(r->len - r->pos) / size) r->bad = 1;
+  return r->bad ? 0 : (long)n;
+}
+
+static int get_magic(byte_reader *r, char kind) {
+  const unsigned char magic[5] = {'H', '3', 'D', (unsigned char)kind, CODEC_VERSION};
+  if (r->len - r->pos < 5 || memcmp(r->in + r->pos, magic, 5) != 0) return 0;
+  r->pos += 5;
+  return 1;
+}
+
+/* vertices whose coordinates, once scaled back, fit in an int */
+static void get_vertices(byte_reader *r, vector<point3d> &vertex, int quant_bits) {
+
+  long n = get_count(r, 3);
+  long long c[3] = {0, 0, 0}, lo = INT_MIN >> quant_bits, hi = INT_MAX >> quant_bits;
+  for (long v = 0; v < n && !r->bad; v++) {
+    long long q[3];
+    for (int i = 0; i < 3; i++) {
+      long long d = get_signed(r);
+      if (d < lo - c[i] || d > hi - c[i]) r->bad = 1;
+      if (!r->bad) c[i] += d;
+      q[i] = (quant_bits > 0) ? c[i] * (1LL << quant_bits) + (1LL << (quant_bits - 1)) : c[i];
+    }
+    point3d p = {(int)q[0], (int)q[1], (int)q[2]};
+    vertex.push_back(p);
+  }
+}
+
+/* an index difference, which is at most bound either way */
+static long long get_index_delta(byte_reader *r, long bound) {
+  long long d = get_signed(r);
+  if (d < -bound || d > bound) r->bad = 1;
+  return r->bad ? 0 : d;
+}
+
+/* faces with indices below nvertex */
+static void get_faces(byte_reader *r, vector<int> &face, long nvertex) {
+
+  long n = get_count(r, 3);
+  long long a = 0;
+  for (long f = 0; f < n && !r->bad; f++) {
+    a += get_index_delta(r, nvertex);
+    long long b = a + get_index_delta(r, nvertex), c = a + get_index_delta(r, nvertex);
+    long long v[3] = {a, b, c};
+    for (int i = 0; i < 3; i++) {
+      if (v[i] < 0 || v[i] >= nvertex) r->bad = 1;
+      face.push_back(v[i]);
+    }
+  }
+}
+
+/* strictly ascending indices below bound. the differences are
+   unsigned and checked against what is left below bound, so that a
+   corrupt one cannot wrap around */
+static void get_indices(byte_reader *r, vector<int> &ids, long bound) {
+
+  long n = get_count(r, 1);
+  unsigned long long i = 0;
+  for (long k = 0; k < n && !r->bad; k++) {
+    unsigned long long d = get_varint(r);
+    if (bound <= 0 || (k > 0 && d == 0) || d >= (unsigned long long)bound - i) {
+      r->bad = 1;
+      break;
+    }
+    i += d;
+    ids.push_back(i);
+  }
+}
+
+
+long decode_hull(const unsigned char *in, long len, hull_data *out) {
+
+  byte_reader r = {in, len, 0, 0};
+  if (!get_magic(&r, 'H') || r.pos >= len) return -1;
+  int quant_bits = in[r.pos++];
+  if (quant_bits > 30) return -1;
+
+  hull_data data;
+  get_vertices(&r, data.vertex, quant_bits);
+  get_faces(&r, data.face, data.vertex.size());
+  if (r.bad) return -1;
+  *out = data;
+  return r.pos;
+}
+
+
+/* a vertex and its index, to look vertices up by their coordinates */
+typedef struct _vertex_ref {
+  point3d p;
+  int id;
+} vertex_ref;
+
+static bool ref_less(const vertex_ref &a, const vertex_ref &b) {
+  if (point_less(a.p, b.p)) return true;
+  if (point_less(b.p, a.p)) return false;
+  return a.id < b.id;
+}
+
+
+long encode_hull_diff(hull_data *old, hull_data *next, vector<unsigned char> &out) {
+
+  size_t start = out.size();
+  int nold = old->vertex.size(), nnext = next->vertex.size();
+  int fold = old->face.size() / 3, fnext = next->face.size() / 3;
+
+  //the old index of every vertex of next, or -1
+  vector<vertex_ref> lookup(nold);
+  for (int v = 0; v < nold; v++) {
+    lookup[v].p = old->vertex[v];
+    lookup[v].id = v;
+  }
+  sort(lookup.begin(), lookup.end(), ref_less);
+  vector<int> in_old(nnext, -1), kept(nold, 0);
+  for (int v = 0; v < nnext; v++) {
+    vertex_ref key = {next->vertex[v], -1};
+    vector<vertex_ref>::iterator it = lower_bound(lookup.begin(), lookup.end(), key, ref_less);
+    if (it != lookup.end() && isEqual(it->p, key.p)) {
+      in_old[v] = it->id;
+      kept[it->id] = 1;
+    }
+  }
+
+  //the vertices after the diff: the kept old ones, then the new ones
+  vector<int> renumber(nold, -1), removed_vertex, index(nnext);
+  vector<point3d> added_vertex;
+  int nv = 0;
+  for (int v = 0; v < nold; v++) {
+    if (kept[v]) {
+      renumber[v] = nv++;
+    } else {
+      removed_vertex.push_back(v);
+    }
+  }
+  for (int v = 0; v < nnext; v++) {
+    if (in_old[v] >= 0) {
+      index[v] = renumber[in_old[v]];
+    } else {
+      index[v] = nv++;
+      added_vertex.push_back(next->vertex[v]);
+    }
+  }
+
+  //the old faces that survive are those of next on kept vertices
+  vector<index_face> old_faces;
+  for (int f = 0; f < fold; f++) {
+    int *c = &old->face[3*f];
+    if (renumber[c[0]] < 0 || renumber[c[1]] < 0 || renumber[c[2]] < 0) continue;
+    old_faces.push_back(make_face(renumber[c[0]], renumber[c[1]], renumber[c[2]], f));
+  }
+  sort(old_faces.begin(), old_faces.end(), face_less);
+  vector<int> face_kept(fold, 0), removed_face, added_face;
+  for (int f = 0; f < fnext; f++) {
+    int *c = &next->face[3*f];
+    index_face g = make_face(index[c[0]], index[c[1]], index[c[2]], f);
+    vector<index_face>::iterator it = lower_bound(old_faces.begin(), old_faces.end(), g, face_less);
+    if (it != old_faces.end() && !face_less(g, *it)) {
+      face_kept[it->id] = 1;
+    } else {
+      added_face.insert(added_face.end(), g.v, g.v + 3);
+    }
+  }
+  for (int f = 0; f < fold; f++) {
+    if (!face_kept[f]) removed_face.push_back(f);
+  }
+
+  put_magic(out, 'D');
+  put_varint(out, nold);
+  put_varint(out, fold);
+  put_varint(out, hull_hash(old));
+  put_indices(out, removed_vertex);
+  put_vertices(out, added_vertex, 0);
+  put_indices(out, removed_face);
+  put_faces(out, added_face);
+  return out.size() - start;
+}
+
+
+long apply_hull_diff(hull_data *data, const unsigned char *in, long len) {
+
+  byte_reader r = {in, len, 0, 0};
+  if (!get_magic(&r, 'D')) return -1;
+  long nv = data->vertex.size(), nf = data->face.size() / 3;
+  if ((long)get_varint(&r) != nv || (long)get_varint(&r) != nf || r.bad) return -1;
+  if (get_varint(&r) != hull_hash(data) || r.bad) return -1;
+
+  vector<int> removed_vertex, removed_face, added_face;
+  vector<point3d> added_vertex;
+  get_indices(&r, removed_vertex, nv);
+  get_vertices(&r, added_vertex, 0);
+  get_indices(&r, removed_face, nf);
+  get_faces(&r, added_face, nv - removed_vertex.size() + added_vertex.size());
+  if (r.bad) return -1;
+
+  //renumber the kept vertices, and check that the kept faces use no
+  //removed vertex before anything is changed
+  vector<int> renumber(nv, 0);
+  vector<char> face_gone(nf, 0);
+  for (size_t k = 0; k < removed_vertex.size(); k++) renumber[removed_vertex[k]] = -1;
+  for (size_t k = 0; k < removed_face.size(); k++) face_gone[removed_face[k]] = 1;
+  hull_data result;
+  for (long v = 0; v < nv; v++) {
+    if (renumber[v] < 0) continue;
+    renumber[v] = result.vertex.size();
+    result.vertex.push_back(data->vertex[v]);
+  }
+  result.vertex.insert(result.vertex.end(), added_vertex.begin(), added_vertex.end());
+  for (long f = 0; f < nf; f++) {
+    if (face_gone[f]) continue;
+    for (int i = 0; i < 3; i++) {
+      int v = renumber[data->face[3*f+i]];
+      if (v < 0) return -1;
+      result.face.push_back(v);
+    }
+  }
+  result.face.insert(result.face.end(), added_face.begin(), added_face.end());
+
+  *data = result;
+  return r.pos;
+}
@@ -0,0 +1,61 @@
+#ifndef __hullcodec_h
+#define __hullcodec_h
+
+#include "geom.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* a hull as a table of distinct vertices and 3 indices per face, in
+   the orientation of brute_force_hull(). this is what is serialized,
+   and what a receiver of diffs keeps */
+typedef struct _hull_data {
+  vector<point3d> vertex;
+  vector<int> face;
+} hull_data;
+
+
+/* the hull data of a face list, or of the corners of a hull_version
+   (3 per face). the vertices are sorted by coordinates and the faces
+   by their vertices, each face starting at its smallest vertex */
+void hull_data_from_faces(vector<triangle3d> &faces, hull_data *out);
+void hull_data_from_corners(const vector<point3d> &corner, hull_data *out);
+
+/* the faces of data as triangles; they point into data->vertex */
+void hull_data_triangles(hull_data *data, vector<triangle3d> &faces);
+
+
+/* append data to out in a compact binary form: the vertex coordinates
+   as varints of their differences to the previous vertex, and the
+   faces as varints of the differences of their indices. with
+   quant_bits > 0 the low quant_bits bits of every coordinate are
+   dropped, so the decoded vertices are within 2^(quant_bits-1) of the
+   originals (and the hull may no longer be exactly convex). returns
+   the number of bytes appended */
+long encode_hull(hull_data *data, int quant_bits, vector<unsigned char> &out);
+
+/* read a hull written by encode_hull() from the len bytes at in.
+   returns the number of bytes read, or -1 if they are not a hull */
+long decode_hull(const unsigned char *in, long len, hull_data *out);
+
+
+/* append to out the changes that turn the hull old into the hull next:
+   the vertices and faces of old that are gone, by index, and the new
+   ones. the receiver applies them to its copy of old with
+   apply_hull_diff(); the sender should do the same to its own copy, as
+   the result has the faces of next but not in its order. returns the
+   number of bytes appended */
+long encode_hull_diff(hull_data *old, hull_data *next, vector<unsigned char> &out);
+
+/* apply a diff written by encode_hull_diff() to data: the remaining
+   vertices and faces keep their order and the new ones are appended.
+   returns the number of bytes read, or -1 (and data is unchanged) if
+   they are not a diff of data: the diff carries the counts and a hash
+   of the hull it was made from, and data must match them */
+long apply_hull_diff(hull_data *data, const unsigned char *in, long len);
+
+#endif
@@ -0,0 +1,298 @@
+/*  hullmesh.cpp
+ *
+ *  adjacency of a hull: face neighbours across edges, and the vertex
+ *  graph used to walk the hull (support points, extents).
+ *
+ */
+
+
+#include "hullmesh.h"
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+
+/* a directed edge u->v, found as edge number e (= 3f+i) of the faces */
+typedef struct _mesh_edge {
+  int u, v, e;
+} mesh_edge;
+
+static bool mesh_edge_less(const mesh_edge &a, const mesh_edge &b) {
+  if (a.u != b.u) return a.u < b.u;
+  return a.v < b.v;
+}
+
+
+int build_hull_mesh(vector<point3d> &points, vector<triangle3d> &hull, hull_mesh *mesh) {
+
+  size_t nf = hull.size();
+  mesh->vert.clear();
+  mesh->face.resize(3 * nf);
+  mesh->nbr.assign(3 * nf, -1);
+  mesh->free.clear();
+  mesh->seen.assign(nf, 0);
+  mesh->visit = 0;
+
+  //number the vertices by their index in points
+  for (size_t f = 0; f < nf; f++) {
+    mesh->face[3*f] = hull[f].a - &points[0];
+    mesh->face[3*f+1] = hull[f].b - &points[0];
+    mesh->face[3*f+2] = hull[f].c - &points[0];
+  }
+  mesh->vert = mesh->face;
+  sort(mesh->vert.begin(), mesh->vert.end());
+  mesh->vert.erase(unique(mesh->vert.begin(), mesh->vert.end()), mesh->vert.end());
+  for (size_t i = 0; i < mesh->face.size(); i++) {
+    mesh->face[i] = lower_bound(mesh->vert.begin(), mesh->vert.end(), mesh->face[i]) -
+                    mesh->vert.begin();
+  }
+
+  //pair every directed edge with its twin
+  vector<mesh_edge> edges(3 * nf);
+  for (size_t e = 0; e < 3 * nf; e++) {
+    size_t next = (e % 3 == 2) ? e - 2 : e + 1;
+    mesh_edge m = {mesh->face[e], mesh->face[next], (int)e};
+    edges[e] = m;
+  }
+  sort(edges.begin(), edges.end(), mesh_edge_less);
+
+  int closed = 1;
+  for (size_t i = 0; i < edges.size(); i++) {
+    if (i+1 < edges.size() && !mesh_edge_less(edges[i], edges[i+1])) {
+      closed = 0;
+      continue;
+    }
+    mesh_edge twin = {edges[i].v, edges[i].u, 0};
+    vector<mesh_edge>::iterator it = lower_bound(edges.begin(), edges.end(), twin, mesh_edge_less);
+    if (it == edges.end() || mesh_edge_less(twin, *it)) {
+      closed = 0;
+      continue;
+    }
+    mesh->nbr[edges[i].e] = it->e / 3;
+  }
+
+  //the vertex graph, from the sorted directed edges: the neighbours of
+  //u are the v of the edges u->v
+  int nv = mesh->vert.size();
+  mesh->vfirst.assign(nv + 1, 0);
+  mesh->vadj.resize(edges.size());
+  for (size_t i = 0; i < edges.size(); i++) {
+    mesh->vfirst[edges[i].u + 1]++;
+    mesh->vadj[i] = edges[i].v;
+  }
+  for (int v = 0; v < nv; v++) mesh->vfirst[v+1] += mesh->vfirst[v];
+
+  return closed;
+}
+
+
+int hull_support(vector<point3d> &points, hull_mesh *mesh, const double dir[3], int start) {
+
+  int v = start;
+  point3d &p = points[mesh->vert[v]];
+  double best = dir[0]*p.x + dir[1]*p.y + dir[2]*p.z;
+
+  //steepest ascent: move to the best neighbour until none is better
+  int next = v;
+  do {
+    v = next;
+    for (int k = mesh->vfirst[v]; k < mesh->vfirst[v+1]; k++) {
+      point3d &q = points[mesh->vert[mesh->vadj[k]]];
+      double d = dir[0]*q.x + dir[1]*q.y + dir[2]*q.z;
+      if (d > best) {
+        best = d;
+        next = mesh->vadj[k];
+      }
+    }
+  } while (next != v);
+  return v;
+}
+
+
+/* a slot for a new face: a dead one if there is any */
+static int new_face(hull_mesh *mesh) {
+
+  if (mesh->free.size() > 0) {
+    int f = mesh->free.back();
+    mesh->free.pop_back();
+    return f;
+  }
+  int f = mesh->face.size() / 3;
+  mesh->face.resize(3 * (f + 1));
+  mesh->nbr.resize(3 * (f + 1));
+  mesh->seen.resize(f + 1, 0);
+  return f;
+}
+
+/* the position in face g of its edge u->v, or -1 */
+static int edge_in_face(hull_mesh *mesh, int g, int u, int v) {
+  for (int j = 0; j < 3; j++) {
+    if (mesh->face[3*g+j] == u && mesh->face[3*g+(j+1)%3] == v) return j;
+  }
+  return -1;
+}
+
+static int has_vertex(hull_mesh *mesh, int f, int v) {
+  return mesh->face[3*f] == v || mesh->face[3*f+1] == v || mesh->face[3*f+2] == v;
+}
+
+
+/* a boundary edge u->v of the region seen from the new point, and the
+   new face built on it */
+typedef struct _horizon_edge {
+  int u, v, f;
+} horizon_edge;
+
+static bool horizon_less(const horizon_edge &a, const horizon_edge &b) {
+  return a.u < b.u;
+}
+
+
+void hull_mesh_insert(vector<point3d> &points, hull_mesh *mesh, int p, int start,
+                      vector<int> *added, vector<int> *removed, vector<int> *gone) {
+
+  point3d q = points[p];
+  mesh->seen.resize(mesh->face.size() / 3, 0);
+  int mark = ++mesh->visit;
+  vector<int> &seen = mesh->seen;
+
+  //flood the region seen from q. seen[f] is mark for the faces in it
+  //and -mark for the faces tested and left out
+  vector<int> region(1, start);
+  seen[start] = mark;
+  for (size_t k = 0; k < region.size(); k++) {
+    int f = region[k];
+    for (int i = 0; i < 3; i++) {
+      int g = mesh->nbr[3*f+i];
+      if (seen[g] == mark || seen[g] == -mark) continue;
+      point3d &a = points[mesh->vert[mesh->face[3*g]]];
+      point3d &b = points[mesh->vert[mesh->face[3*g+1]]];
+      point3d &c = points[mesh->vert[mesh->face[3*g+2]]];
+      if (volume_sign(a, b, c, q) >= 0) {
+        seen[g] = mark;
+        region.push_back(g);
+      } else {
+        seen[g] = -mark;
+      }
+    }
+  }
+
+  //its boundary, and the vertices inside it
+  vector<horizon_edge> horizon;
+  vector<int> inner;
+  for (size_t k = 0; k < region.size(); k++) {
+    int f = region[k];
+    for (int i = 0; i < 3; i++) {
+      inner.push_back(mesh->face[3*f+i]);
+      if (seen[mesh->nbr[3*f+i]] != mark) {
+        horizon_edge h = {mesh->face[3*f+i], mesh->face[3*f+(i+1)%3], mesh->nbr[3*f+i]};
+        horizon.push_back(h);
+      }
+    }
+  }
+
+  //remove the region
+  for (size_t k = 0; k < region.size(); k++) {
+    mesh->face[3*region[k]] = DEAD_FACE;
+    mesh->free.push_back(region[k]);
+    if (removed) removed->push_back(region[k]);
+  }
+
+  //a fan of faces u,v,q over the horizon. the face across u->v is the
+  //old neighbour, the one across v->q is the fan face starting at v
+  int w = mesh->vert.size();
+  mesh->vert.push_back(p);
+  for (size_t k = 0; k < horizon.size(); k++) {
+    int f = new_face(mesh);
+    int g = horizon[k].f;
+    mesh->face[3*f] = horizon[k].u;
+    mesh->face[3*f+1] = horizon[k].v;
+    mesh->face[3*f+2] = w;
+    mesh->nbr[3*f] = g;
+    mesh->nbr[3*g + edge_in_face(mesh, g, horizon[k].v, horizon[k].u)] = f;
+    mesh->seen[f] = 0;
+    horizon[k].f = f;
+    if (added) added->push_back(f);
+  }
+  sort(horizon.begin(), horizon.end(), horizon_less);
+  for (size_t k = 0; k < horizon.size(); k++) {
+    horizon_edge key = {horizon[k].v, 0, 0};
+    int next = lower_bound(horizon.begin(), horizon.end(), key, horizon_less)->f;
+    mesh->nbr[3*horizon[k].f + 1] = next;
+    mesh->nbr[3*next + 2] = horizon[k].f;
+  }
+
+  if (gone) {
+    sort(inner.begin(), inner.end());
+    inner.erase(unique(inner.begin(), inner.end()), inner.end());
+    for (size_t k = 0; k < inner.size(); k++) {
+      horizon_edge key = {inner[k], 0, 0};
+      vector<horizon_edge>::iterator it = lower_bound(horizon.begin(), horizon.end(), key,
+                                                      horizon_less);
+      if (it == horizon.end() || it->u != inner[k]) gone->push_back(mesh->vert[inner[k]]);
+    }
+  }
+}
+
+
+int hull_mesh_flip(hull_mesh *mesh, int e) {
+
+  //f = a,b,c with e the edge a->b, and g = b,a,d across it
+  int f = e / 3, i = e % 3, g = mesh->nbr[e];
+  int a = mesh->face[3*f+i], b = mesh->face[3*f+(i+1)%3], c = mesh->face[3*f+(i+2)%3];
+  int j = edge_in_face(mesh, g, b, a);
+  int d = mesh->face[3*g+(j+2)%3];
+  int f_bc = mesh->nbr[3*f+(i+1)%3], f_ca = mesh->nbr[3*f+(i+2)%3];
+  int g_ad = mesh->nbr[3*g+(j+1)%3], g_db = mesh->nbr[3*g+(j+2)%3];
+
+  if (c == d) return 0;
+
+  //walk around c: if a face there has d, c-d is already an edge
+  int cur = f, steps = 0;
+  do {
+    if (cur != f && cur != g && has_vertex(mesh, cur, d)) return 0;
+    int k = 0;
+    while (mesh->face[3*cur+k] != c) k++;
+    cur = mesh->nbr[3*cur+k];
+  } while (cur != f && ++steps < (int)mesh->face.size());
+
+  //f becomes a,d,c and g becomes b,c,d
+  mesh->face[3*f] = a; mesh->face[3*f+1] = d; mesh->face[3*f+2] = c;
+  mesh->nbr[3*f] = g_ad; mesh->nbr[3*f+1] = g; mesh->nbr[3*f+2] = f_ca;
+  mesh->face[3*g] = b; mesh->face[3*g+1] = c; mesh->face[3*g+2] = d;
+  mesh->nbr[3*g] = f_bc; mesh->nbr[3*g+1] = f; mesh->nbr[3*g+2] = g_db;
+
+  mesh->nbr[3*g_ad + edge_in_face(mesh, g_ad, d, a)] = f;
+  mesh->nbr[3*f_bc + edge_in_face(mesh, f_bc, c, b)] = g;
+  return 1;
+}
+
+
+int hull_mesh_outside(vector<point3d> &points, hull_mesh *mesh, point3d p) {
+
+  int nf = mesh->face.size() / 3;
+  for (int f = 0; f < nf; f++) {
+    if (mesh->face[3*f] == DEAD_FACE) continue;
+    point3d &a = points[mesh->vert[mesh->face[3*f]]];
+    point3d &b = points[mesh->vert[mesh->face[3*f+1]]];
+    point3d &c = points[mesh->vert[mesh->face[3*f+2]]];
+    if (volume_sign(a, b, c, p) > 0) return f;
+  }
+  return -1;
+}
+
+
+void hull_mesh_faces(vector<point3d> &points, hull_mesh *mesh, vector<triangle3d> &hull) {
+
+  size_t nf = mesh->face.size() / 3;
+  hull.clear();
+  hull.reserve(nf - mesh->free.size());
+  for (size_t f = 0; f < nf; f++) {
+    if (mesh->face[3*f] == DEAD_FACE) continue;
+    triangle3d t = {&points[mesh->vert[mesh->face[3*f]]], &points[mesh->vert[mesh->face[3*f+1]]],
+                    &points[mesh->vert[mesh->face[3*f+2]]]};
+    hull.push_back(t);
+  }
+}
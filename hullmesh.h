@@ -0,0 +1,68 @@
+#ifndef __hullmesh_h
+#define __hullmesh_h
+
+#include "geom.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* a hull with its adjacency: which faces meet at each edge and which
+   vertices are joined by an edge. vertices are numbered 0..V-1 and
+   vert[] maps them back to the points */
+typedef struct _hull_mesh {
+  vector<int> vert;    //index in points of each hull vertex
+  vector<int> face;    //3 vertex ids per face, oriented like the hull
+  vector<int> nbr;     //nbr[3f+i] is the face across the edge face[3f+i] -> face[3f+(i+1)%3]
+  vector<int> vfirst;  //the neighbours of vertex v are vadj[vfirst[v] .. vfirst[v+1])
+  vector<int> vadj;
+
+  //used while the mesh is edited by hull_mesh_insert() and
+  //hull_mesh_flip(). they do not update vfirst/vadj, and vert may keep
+  //vertices that are no longer on the hull
+  vector<int> free;    //dead faces (face[3f] == DEAD_FACE), reused first
+  vector<int> seen;    //per face scratch marks
+  int visit;
+} hull_mesh;
+
+#define DEAD_FACE -1
+
+
+/* build the adjacency of a hull whose faces point into points. returns
+   1 on success and 0 if the hull is not a closed surface (every edge
+   must be shared by exactly two faces, in opposite directions) */
+int build_hull_mesh(vector<point3d> &points, vector<triangle3d> &hull, hull_mesh *mesh);
+
+/* return the id of a vertex of the mesh that is furthest in direction
+   dir, walking the vertex graph uphill from vertex start. on a convex
+   hull the walk cannot get stuck, and it visits only the vertices on
+   its way */
+int hull_support(vector<point3d> &points, hull_mesh *mesh, const double dir[3], int start);
+
+/* add points[p] to the mesh. the faces p is strictly outside of, and
+   the ones next to them that p is on the plane of, are replaced by a
+   fan of faces from the boundary of that region to p. start must be a
+   face p is strictly outside of. the new faces are appended to added,
+   the removed ones to removed (their slots may have been reused by new
+   faces) and the points that are no longer hull vertices to gone. any
+   of the three may be NULL */
+void hull_mesh_insert(vector<point3d> &points, hull_mesh *mesh, int p, int start,
+                      vector<int> *added, vector<int> *removed, vector<int> *gone);
+
+/* replace the edge e = 3f+i, a diagonal of the quadrilateral formed by
+   the faces f and nbr[e], by the other diagonal. returns 1 on success
+   and 0 (leaving the mesh unchanged) if that diagonal is already an
+   edge of the mesh */
+int hull_mesh_flip(hull_mesh *mesh, int e);
+
+/* a live face of the mesh that p is strictly outside of, or -1 if p is
+   inside or on the hull. looks at every face */
+int hull_mesh_outside(vector<point3d> &points, hull_mesh *mesh, point3d p);
+
+/* the live faces of the mesh as triangles pointing into points */
+void hull_mesh_faces(vector<point3d> &points, hull_mesh *mesh, vector<triangle3d> &hull);
+
+#endif
@@ -0,0 +1,176 @@
+/*  hullmetrics.cpp
+ *
+ *  volume, surface area, centroid, inertia tensor and bounding box of
+ *  a hull, all accumulated in one pass over the faces.
+ *
+ *  every face abc is the base of a tetrahedron with apex r, the first
+ *  corner of the hull. the signed volumes and moments of these
+ *  tetrahedra add up to those of the solid (divergence theorem).
+ *
+ */
+
+
+#include "hullmetrics.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+//below this many faces the threads cost more than they save
+const size_t PARALLEL_FACES = 20000;
+
+
+/* the sums of one range of faces, relative to the apex r */
+typedef struct _metric_sums {
+  double det;          //6 times the signed volume
+  double area2;        //2 times the area
+  double first[3];     //24 times the first moment
+  double second[3][3]; //120 times the second moment
+  int lo[3], hi[3];
+} metric_sums;
+
+
+static void sum_faces(vector<triangle3d> *hull, point3d r, size_t from, size_t to,
+                      metric_sums *s) {
+
+  memset(s, 0, sizeof(metric_sums));
+  for (int i = 0; i < 3; i++) {
+    s->lo[i] = INT_MAX;
+    s->hi[i] = INT_MIN;
+  }
+
+  for (size_t f = from; f < to; f++) {
+    triangle3d &t = (*hull)[f];
+    double a[3] = {(double)t.a->x - r.x, (double)t.a->y - r.y, (double)t.a->z - r.z};
+    double b[3] = {(double)t.b->x - r.x, (double)t.b->y - r.y, (double)t.b->z - r.z};
+    double c[3] = {(double)t.c->x - r.x, (double)t.c->y - r.y, (double)t.c->z - r.z};
+
+    //area from the cross product of two edges
+    double ux = b[0]-a[0], uy = b[1]-a[1], uz = b[2]-a[2];
+    double vx = c[0]-a[0], vy = c[1]-a[1], vz = c[2]-a[2];
+    double nx = uy*vz - uz*vy, ny = uz*vx - ux*vz, nz = ux*vy - uy*vx;
+    s->area2 += sqrt(nx*nx + ny*ny + nz*nz);
+
+    //tetrahedron r,a,b,c
+    double det = a[0]*(b[1]*c[2] - b[2]*c[1]) - a[1]*(b[0]*c[2] - b[2]*c[0]) +
+                 a[2]*(b[0]*c[1] - b[1]*c[0]);
+    double sum[3] = {a[0]+b[0]+c[0], a[1]+b[1]+c[1], a[2]+b[2]+c[2]};
+    s->det += det;
+    for (int i = 0; i < 3; i++) {
+      s->first[i] += det * sum[i];
+      for (int j = i; j < 3; j++) {
+        s->second[i][j] += det * (a[i]*a[j] + b[i]*b[j] + c[i]*c[j] + sum[i]*sum[j]);
+      }
+    }
+
+    //bounding box
+    point3d *corner[3] = {t.a, t.b, t.c};
+    for (int k = 0; k < 3; k++) {
+      int p[3] = {corner[k]->x, corner[k]->y, corner[k]->z};
+      for (int i = 0; i < 3; i++) {
+        s->lo[i] = min(s->lo[i], p[i]);
+        s->hi[i] = max(s->hi[i], p[i]);
+      }
+    }
+  }
+}
+
+
+void compute_hull_metrics(vector<triangle3d> &hull, hull_metrics *m, int nthreads) {
+
+  memset(m, 0, sizeof(hull_metrics));
+  m->nfaces = hull.size();
+  m->valid = 1;
+  if (hull.size() == 0) return;
+
+  if (nthreads <= 0) nthreads = thread::hardware_concurrency();
+  if (nthreads <= 0 || hull.size() < PARALLEL_FACES) nthreads = 1;
+
+  point3d r = *hull[0].a;
+  vector<metric_sums> part(nthreads);
+  size_t chunk = (hull.size() + nthreads - 1) / nthreads;
+  if (nthreads == 1) {
+    sum_faces(&hull, r, 0, hull.size(), &part[0]);
+  } else {
+    vector<thread> workers;
+    for (int t = 0; t < nthreads; t++) {
+      size_t from = min(hull.size(), t * chunk), to = min(hull.size(), from + chunk);
+      workers.push_back(thread(sum_faces, &hull, r, from, to, &part[t]));
+    }
+    for (int t = 0; t < nthreads; t++) workers[t].join();
+  }
+
+  //reduce the partial sums
+  metric_sums s = part[0];
+  for (int t = 1; t < nthreads; t++) {
+    s.det += part[t].det;
+    s.area2 += part[t].area2;
+    for (int i = 0; i < 3; i++) {
+      s.first[i] += part[t].first[i];
+      for (int j = i; j < 3; j++) s.second[i][j] += part[t].second[i][j];
+      s.lo[i] = min(s.lo[i], part[t].lo[i]);
+      s.hi[i] = max(s.hi[i], part[t].hi[i]);
+    }
+  }
+
+  //the hull engines orient their faces inward, which makes all the
+  //volume terms negative
+  double sign = (s.det < 0) ? -1 : 1;
+  m->volume = sign * s.det / 6;
+  m->area = s.area2 / 2;
+  for (int i = 0; i < 3; i++) {
+    m->bbox_min[i] = s.lo[i];
+    m->bbox_max[i] = s.hi[i];
+  }
+
+  double rel[3] = {0, 0, 0};
+  double origin[3] = {(double)r.x, (double)r.y, (double)r.z};
+  if (m->volume > 0) {
+    for (int i = 0; i < 3; i++) rel[i] = sign * s.first[i] / 24 / m->volume;
+  } else {
+    //a flat hull: use the center of its bounding box
+    for (int i = 0; i < 3; i++) rel[i] = (s.lo[i] + (double)s.hi[i]) / 2 - origin[i];
+  }
+  for (int i = 0; i < 3; i++) m->centroid[i] = origin[i] + rel[i];
+
+  //second moment about the centroid, then the inertia tensor
+  double cov[3][3];
+  for (int i = 0; i < 3; i++) {
+    for (int j = i; j < 3; j++) {
+      cov[i][j] = sign * s.second[i][j] / 120 - m->volume * rel[i] * rel[j];
+      cov[j][i] = cov[i][j];
+    }
+  }
+  double trace = cov[0][0] + cov[1][1] + cov[2][2];
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      m->inertia[i][j] = (i == j ? trace : 0) - cov[i][j];
+    }
+  }
+}
+
+
+hull_metrics *cached_hull_metrics(vector<triangle3d> &hull, hull_metrics *m, int nthreads) {
+
+  if (!m->valid) compute_hull_metrics(hull, m, nthreads);
+  return m;
+}
+
+
+void print_hull_metrics(hull_metrics *m) {
+
+  printf("hull: %d faces, volume %.1f, area %.1f\n", m->nfaces, m->volume, m->area);
+  printf("  centroid (%.2f, %.2f, %.2f)\n", m->centroid[0], m->centroid[1], m->centroid[2]);
+  printf("  bbox [%d, %d] x [%d, %d] x [%d, %d]\n", m->bbox_min[0], m->bbox_max[0],
+         m->bbox_min[1], m->bbox_max[1], m->bbox_min[2], m->bbox_max[2]);
+  printf("  inertia [%.4g %.4g %.4g; %.4g %.4g %.4g; %.4g %.4g %.4g]\n",
+         m->inertia[0][0], m->inertia[0][1], m->inertia[0][2],
+         m->inertia[1][0], m->inertia[1][1], m->inertia[1][2],
+         m->inertia[2][0], m->inertia[2][1], m->inertia[2][2]);
+}
@@ -0,0 +1,35 @@
+#ifndef __hullmetrics_h
+#define __hullmetrics_h
+
+#include "geom.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* quantities derived from a closed hull, for a solid of unit density */
+typedef struct _hull_metrics {
+  double volume, area;
+  double centroid[3];
+  double inertia[3][3];   //inertia tensor about the centroid
+  int bbox_min[3], bbox_max[3];
+  int nfaces;
+  int valid;  //0 until computed; reset it to 0 whenever the hull changes
+} hull_metrics;
+
+
+/* compute all the metrics of the hull in a single pass over its faces,
+   split over nthreads threads (0 means one per core). the faces may be
+   oriented either way, as long as they are oriented consistently */
+void compute_hull_metrics(vector<triangle3d> &hull, hull_metrics *m, int nthreads);
+
+/* return m, computing it first if it is not valid. m cannot tell that
+   the hull changed: whoever changes it sets m->valid to 0 */
+hull_metrics *cached_hull_metrics(vector<triangle3d> &hull, hull_metrics *m, int nthreads);
+
+void print_hull_metrics(hull_metrics *m);
+
+#endif
@@ -0,0 +1,225 @@
+/*  hullselect.cpp
+ *
+ *  picking a hull engine from a cheap look at the input.
+ *
+ */
+
+
+#include "hullselect.h"
+#include "incremental.h"
+#include "giftwrap.h"
+#include "dedup.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+//points sampled by compute_hull()
+const int HULL_SAMPLES = 2000;
+
+//gift wrapping wins up to about this many hull vertices per log2(n)
+const double GIFTWRAP_VERTICES_PER_LOG = 8;
+
+//brute force is only correct without 4 coplanar points, and O(n^4)
+const int BRUTE_FORCE_POINTS = 12;
+
+//remove the repeated points first above this fraction of repeats in the sample
+const double DEDUP_FRACTION = 0.05;
+
+//gift wrapping sorts every point on a facet; above this fraction of
+//the sample on the boundary of its hull it is not used
+const double COPLANAR_FRACTION = 0.25;
+
+//below this many points per core the chunks cost more than they save
+const long PARALLEL_POINTS_PER_CORE = 100000;
+
+
+/* vertices of the hull of every stride-th point and of the extreme
+   points, which keep the corners of a polytope in any sample. the hull
+   is left in mesh */
+static long sample_vertices(vector<point3d> &points, vector<int> &ext, long stride,
+                            hull_mesh *mesh) {
+
+  vector<int> ids(ext);
+  for (long i = 0; i < (long)points.size(); i += stride) ids.push_back(i);
+  incremental_hull_mesh(points, ids, mesh);
+
+  //a closed triangulated sphere has F = 2V - 4
+  long nf = mesh->face.size() / 3 - mesh->free.size();
+  return (nf > 0) ? nf / 2 + 2 : 0;
+}
+
+
+/* estimate_hull_vertices(), with the hull of the quarter sample left
+   in mesh */
+static long estimate_hull(vector<point3d> &points, int samples, hull_mesh *mesh) {
+
+  long n = points.size();
+  vector<int> ext;
+  extreme_points(points, ext);
+  if (n <= samples) return sample_vertices(points, ext, 1, mesh);
+
+  long stride = n / samples;
+  double h = sample_vertices(points, ext, stride, mesh);
+  double hq = sample_vertices(points, ext, 4 * stride, mesh);
+  if (h == 0) return 0;
+
+  //h grows like m^a for m sample points: a is 0 for a polytope with a
+  //few corners, 1/3 in a ball, 1 on a sphere
+  double m = (double)n / stride, a = 0;
+  if (hq > 0) a = min(1.0, max(0.0, log(h / hq) / log(4.0)));
+  return (long)ceil(h * pow(n / m, a));
+}
+
+
+long estimate_hull_vertices(vector<point3d> &points, int samples) {
+  hull_mesh mesh;
+  return estimate_hull(points, samples, &mesh);
+}
+
+
+/* the fraction of every stride-th point that is on the plane of a face
+   of mesh: points on flat facets, 1 if the mesh is flat */
+static double coplanar_fraction(vector<point3d> &points, hull_mesh *mesh, long stride) {
+
+  int nf = mesh->face.size() / 3;
+  long sampled = 0, flat = 0;
+  for (long i = 0; i < (long)points.size(); i += stride) {
+    sampled++;
+    for (int f = 0; f < nf; f++) {
+      if (mesh->face[3*f] == DEAD_FACE) continue;
+      if (volume_sign(points[mesh->vert[mesh->face[3*f]]], points[mesh->vert[mesh->face[3*f+1]]],
+                      points[mesh->vert[mesh->face[3*f+2]]], points[i]) == 0) {
+        flat++;
+        break;
+      }
+    }
+  }
+  return (mesh->face.size() / 3 > mesh->free.size()) ? (double)flat / sampled : 1;
+}
+
+
+static bool point_less(const point3d &a, const point3d &b) {
+  if (a.x != b.x) return a.x < b.x;
+  if (a.y != b.y) return a.y < b.y;
+  return a.z < b.z;
+}
+
+
+/* 1 if no 4 of the points are on a plane; O(n^4) */
+static int general_position(vector<point3d> &points) {
+
+  int n = points.size();
+  for (int i = 0; i < n; i++) {
+    for (int j = i+1; j < n; j++) {
+      for (int k = j+1; k < n; k++) {
+        for (int l = k+1; l < n; l++) {
+          if (volume_sign(points[i], points[j], points[k], points[l]) == 0) return 0;
+        }
+      }
+    }
+  }
+  return 1;
+}
+
+
+const char *choose_hull_engine(vector<point3d> &points, int nthreads, hull_stats *stats) {
+
+  long n = points.size();
+  stats->n = n;
+  stats->cores = (nthreads > 0) ? nthreads : thread::hardware_concurrency();
+  if (stats->cores <= 0) stats->cores = 1;
+  stats->hull_estimate = 0;
+  stats->duplicates = 0;
+  stats->coplanar = 0;
+  if (n == 0) return "incremental";
+
+  //repeated points in an evenly spaced sample
+  long stride = max(1L, n / HULL_SAMPLES);
+  vector<point3d> sample;
+  for (long i = 0; i < n; i += stride) sample.push_back(points[i]);
+  sort(sample.begin(), sample.end(), point_less);
+  long repeats = 0;
+  for (size_t k = 1; k < sample.size(); k++) repeats += isEqual(sample[k-1], sample[k]);
+  stats->duplicates = (double)repeats / sample.size();
+
+  //brute force drops the faces with 4 coplanar points
+  if (n >= 4 && n <= BRUTE_FORCE_POINTS && general_position(points)) return "brute_force";
+
+  //a sample hull would cost about as much as the hull itself
+  if (n <= HULL_SAMPLES) {
+    stats->hull_estimate = -1;
+    return "incremental";
+  }
+
+  //gift wrapping when the hull is small, unless many points are on its
+  //facets. the probe only runs then, on the quarter sample, when the
+  //sample hull has few faces
+  hull_mesh mesh;
+  stats->hull_estimate = estimate_hull(points, HULL_SAMPLES, &mesh);
+  if (stats->hull_estimate <= GIFTWRAP_VERTICES_PER_LOG * log2((double)max(n, 2L))) {
+    stats->coplanar = coplanar_fraction(points, &mesh, 4 * stride);
+    if (stats->coplanar < COPLANAR_FRACTION) return "giftwrap";
+  }
+  if (stats->cores > 1 && n >= PARALLEL_POINTS_PER_CORE * stats->cores) return "parallel";
+  return "incremental";
+}
+
+
+/* the hull of the points by the engine called name */
+static vector<triangle3d> run_engine(const char *engine, vector<point3d> &points, int nthreads) {
+
+  if (strcmp(engine, "brute_force") == 0) return brute_force_hull(points);
+  if (strcmp(engine, "giftwrap") == 0) return giftwrap_hull(points, nthreads);
+  if (strcmp(engine, "parallel") == 0) return parallel_hull(points, nthreads);
+  if (strcmp(engine, "incremental") != 0) {
+    printf("compute_hull: unknown engine %s, using incremental\n", engine);
+  }
+  return incremental_hull(points);
+}
+
+
+vector<triangle3d> compute_hull(vector<point3d> &points, const hull_options *opt) {
+
+  hull_options defaults = {NULL, 0, 0, 0};
+  if (!opt) opt = &defaults;
+
+  const char *engine = opt->engine;
+  int dedup = opt->grid > 1;
+  if (!engine || strcmp(engine, "auto") == 0) {
+    hull_stats stats;
+    engine = choose_hull_engine(points, opt->nthreads, &stats);
+    if (stats.duplicates >= DEDUP_FRACTION) dedup = 1;
+    if (opt->verbose) {
+      printf("compute_hull: n=%ld hull~%ld duplicates=%.2f coplanar=%.2f cores=%d -> %s\n",
+             stats.n, stats.hull_estimate, stats.duplicates, stats.coplanar, stats.cores, engine);
+    }
+  } else if (opt->verbose) {
+    printf("compute_hull: n=%ld -> %s (forced)\n", (long)points.size(), engine);
+  }
+  vector<triangle3d> hull;
+  if (!dedup) {
+    hull = run_engine(engine, points, opt->nthreads);
+  } else {
+    dedup_table d;
+    long m = dedup_points(points, opt->grid, &d, opt->nthreads);
+    if (opt->verbose) {
+      printf("compute_hull: %ld distinct points after snapping to %d\n", m, max(opt->grid, 1));
+    }
+    hull = run_engine(engine, d.points, opt->nthreads);
+    dedup_faces(&d, points, hull);
+  }
+  //the engines that grow their output leave up to half of it unused
+  hull.shrink_to_fit();
+  return hull;
+}
+
+
+vector<triangle3d> auto_hull(vector<point3d> &points) {
+  return compute_hull(points, NULL);
+}
@@ -0,0 +1,65 @@
+#ifndef __hullselect_h
+#define __hullselect_h
+
+#include "geom.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* how compute_hull() should run */
+typedef struct _hull_options {
+  const char *engine;  //"brute_force", "incremental", "giftwrap" or "parallel"; NULL or "auto" to choose
+  int nthreads;        //0 means one per core
+  int verbose;         //1 to print what was chosen and why
+  int grid;            //> 1 to snap the points to multiples of grid first (dedup.h);
+                       //the hull is then NOT exactly convex, see dedup_faces()
+} hull_options;
+
+/* what compute_hull() looked at. the coordinate range is not among
+   them: it does not favour any engine, as every one decides with the
+   exact volume_sign() (geom.h, in __int128) at any int coordinates, and
+   the floating point filter of gift wrapping bounds its error relative
+   to the coordinates it is given */
+typedef struct _hull_stats {
+  long n;
+  long hull_estimate;  //estimate_hull_vertices(), -1 if n is too small to sample
+  double duplicates;   //fraction of the sample that repeats a sampled point
+  double coplanar;     //fraction of a sample on the planes of its hull faces, when measured
+  int cores;
+} hull_stats;
+
+
+/* estimate how many vertices the hull of the points has, from the
+   hulls of an evenly spaced sample of about samples points and of a
+   quarter of it, both with the extreme points of giftwrap.h added. the
+   growth between the two is extrapolated to n */
+long estimate_hull_vertices(vector<point3d> &points, int samples);
+
+/* sample the points and return the engine compute_hull() would choose
+   for them with nthreads threads. inputs of at most the sample size are
+   not sampled */
+const char *choose_hull_engine(vector<point3d> &points, int nthreads, hull_stats *stats);
+
+/* compute and return the convex hull of the points with the engine
+   named in opt, or with the one that should be fastest for them: brute
+   force for a handful of points in general position, gift wrapping
+   when the hull is estimated to be small (O(n h) against O(n log n))
+   and few points lie on its facets (in flat or nearly flat input gift
+   wrapping sorts every point of a facet), chunks in parallel for large
+   inputs when there are several cores, and the incremental engine
+   otherwise and for inputs too small to sample. the repeated points
+   are removed first when the sample has many, or when opt->grid asks
+   for snapping; the faces still point into points. with opt->grid > 1
+   they point to unsnapped points and the result may not be convex.
+   opt may be NULL */
+vector<triangle3d> compute_hull(vector<point3d> &points, const hull_options *opt);
+
+/* compute_hull() with the default options, with the signature of
+   brute_force_hull() */
+vector<triangle3d> auto_hull(vector<point3d> &points);
+
+#endif
@@ -0,0 +1,177 @@
+/*  hullversion.cpp
+ *
+ *  a hull that readers query while a writer keeps inserting points.
+ *
+ *  the writer never changes a published version. it builds the next
+ *  one from its own mesh, swaps the current pointer and bumps the
+ *  epoch. a reader announces the epoch before it loads the pointer, so
+ *  a reader that announced epoch e or later cannot hold a version that
+ *  was replaced before the epoch became e. a replaced version is freed
+ *  once every announcement is either idle or at least that epoch.
+ *
+ *  all the atomics use the default sequentially consistent ordering.
+ *
+ */
+
+
+#include "hullversion.h"
+#include "incremental.h"
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+
+/* a new version from the live faces of the writer's mesh */
+static hull_version *make_version(versioned_hull *vh, unsigned long epoch) {
+
+  hull_version *v = new hull_version;
+  hull_mesh *mesh = &vh->mesh;
+  int nf = mesh->face.size() / 3;
+  v->corner.reserve(3 * (nf - mesh->free.size()));
+  for (int f = 0; f < nf; f++) {
+    if (mesh->face[3*f] == DEAD_FACE) continue;
+    for (int i = 0; i < 3; i++) v->corner.push_back(vh->points[mesh->vert[mesh->face[3*f+i]]]);
+  }
+  v->npoints = vh->points.size();
+  v->epoch = epoch;
+  return v;
+}
+
+
+void versioned_hull_init(versioned_hull *vh, vector<point3d> &points) {
+
+  vh->points = points;
+  vector<int> ids(points.size());
+  for (size_t i = 0; i < points.size(); i++) ids[i] = i;
+  incremental_hull_mesh(vh->points, ids, &vh->mesh);
+
+  for (int r = 0; r < MAX_HULL_READERS; r++) {
+    vh->reading[r].store(0);
+    vh->registered[r].store(0);
+  }
+  vh->retired.clear();
+  vh->epoch.store(1);
+  vh->current.store(make_version(vh, 1));
+}
+
+
+void versioned_hull_insert(versioned_hull *vh, vector<point3d> &batch) {
+
+  hull_mesh *mesh = &vh->mesh;
+  int first = vh->points.size();
+  vh->points.insert(vh->points.end(), batch.begin(), batch.end());
+  int nlive = mesh->face.size() / 3 - mesh->free.size();
+
+  if (nlive == 0 || (int)batch.size() > nlive) {
+    //no hull yet, or more new points than faces: rebuild from the hull
+    //vertices and the batch (every point while there is no hull)
+    vector<int> ids;
+    if (nlive == 0) {
+      for (size_t i = 0; i < vh->points.size(); i++) ids.push_back(i);
+    } else {
+      for (size_t f = 0; f < mesh->face.size() / 3; f++) {
+        if (mesh->face[3*f] == DEAD_FACE) continue;
+        for (int i = 0; i < 3; i++) ids.push_back(mesh->vert[mesh->face[3*f+i]]);
+      }
+      sort(ids.begin(), ids.end());
+      ids.erase(unique(ids.begin(), ids.end()), ids.end());
+      for (size_t i = first; i < vh->points.size(); i++) ids.push_back(i);
+    }
+    incremental_hull_mesh(vh->points, ids, &vh->mesh);
+  } else {
+    for (size_t i = first; i < vh->points.size(); i++) {
+      int f = hull_mesh_outside(vh->points, mesh, vh->points[i]);
+      if (f >= 0) hull_mesh_insert(vh->points, mesh, i, f, NULL, NULL, NULL);
+    }
+  }
+
+  //publish, then retire the old version under the new epoch
+  unsigned long e = vh->epoch.load() + 1;
+  hull_version *old = vh->current.exchange(make_version(vh, e));
+  vh->epoch.store(e);
+  retired_version r = {old, e};
+  vh->retired.push_back(r);
+  versioned_hull_reclaim(vh);
+}
+
+
+int versioned_hull_reclaim(versioned_hull *vh) {
+
+  //the oldest epoch a reader is still in
+  unsigned long oldest = vh->epoch.load();
+  for (int r = 0; r < MAX_HULL_READERS; r++) {
+    unsigned long e = vh->reading[r].load();
+    if (e != 0 && e < oldest) oldest = e;
+  }
+
+  size_t kept = 0;
+  for (size_t k = 0; k < vh->retired.size(); k++) {
+    if (vh->retired[k].epoch <= oldest) {
+      delete vh->retired[k].version;
+    } else {
+      vh->retired[kept++] = vh->retired[k];
+    }
+  }
+  vh->retired.resize(kept);
+  return kept;
+}
+
+
+void versioned_hull_free(versioned_hull *vh) {
+
+  for (size_t k = 0; k < vh->retired.size(); k++) delete vh->retired[k].version;
+  vh->retired.clear();
+  delete vh->current.exchange(NULL);
+}
+
+
+int versioned_hull_reader(versioned_hull *vh) {
+
+  for (int r = 0; r < MAX_HULL_READERS; r++) {
+    int idle = 0;
+    if (vh->registered[r].compare_exchange_strong(idle, 1)) return r;
+  }
+  return -1;
+}
+
+
+void versioned_hull_release(versioned_hull *vh, int reader) {
+  vh->reading[reader].store(0);
+  vh->registered[reader].store(0);
+}
+
+
+const hull_version *versioned_hull_enter(versioned_hull *vh, int reader) {
+
+  //announce first: the writer frees nothing this reader can load from
+  //now on, and the version loaded below is at least as new as the
+  //announced epoch
+  vh->reading[reader].store(vh->epoch.load());
+  return vh->current.load();
+}
+
+
+void versioned_hull_leave(versioned_hull *vh, int reader) {
+  vh->reading[reader].store(0);
+}
+
+
+int hull_version_contains(const hull_version *v, point3d p) {
+
+  if (v->corner.size() == 0) return 0;
+  for (size_t f = 0; f < v->corner.size(); f += 3) {
+    if (volume_sign(v->corner[f], v->corner[f+1], v->corner[f+2], p) > 0) return 0;
+  }
+  return 1;
+}
+
+
+int versioned_hull_contains(versioned_hull *vh, int reader, point3d p) {
+
+  const hull_version *v = versioned_hull_enter(vh, reader);
+  int inside = hull_version_contains(v, p);
+  versioned_hull_leave(vh, reader);
+  return inside;
+}
@@ -0,0 +1,91 @@
+#ifndef __hullversion_h
+#define __hullversion_h
+
+#include "geom.h"
+#include "hullmesh.h"
+
+#include <atomic>
+#include <vector>
+
+
+using namespace std;
+
+
+
+//most reader threads that can use a versioned hull at the same time
+#define MAX_HULL_READERS 64
+
+
+/* one published hull. it is never changed after it is published, so
+   readers can use it without locks. the corners are copies, not
+   pointers into the writer's points, which may move when they grow */
+typedef struct _hull_version {
+  vector<point3d> corner;   //3 per face, oriented like brute_force_hull()
+  long npoints;             //points inserted when it was published
+  unsigned long epoch;      //1 for the first version, then 2, 3, ...
+} hull_version;
+
+/* a version that was replaced, and the epoch from which on no new
+   reader can see it */
+typedef struct _retired_version {
+  hull_version *version;
+  unsigned long epoch;
+} retired_version;
+
+
+/* a hull that one writer thread grows by inserting points while any
+   number of reader threads (up to MAX_HULL_READERS) query it.
+
+   readers never wait: they announce the epoch they start in, read the
+   current version, and clear their announcement when they are done.
+   the writer builds each new version on the side, publishes it with a
+   single atomic exchange and keeps the old one until every reader that
+   could have seen it has left (epoch based reclamation) */
+typedef struct _versioned_hull {
+  atomic<hull_version*> current;
+  atomic<unsigned long> epoch;
+  atomic<unsigned long> reading[MAX_HULL_READERS];  //0 if the reader is idle
+  atomic<int> registered[MAX_HULL_READERS];
+
+  //used by the writer only
+  vector<point3d> points;          //every point inserted so far
+  hull_mesh mesh;                  //their hull, in edited form
+  vector<retired_version> retired; //replaced versions not freed yet
+} versioned_hull;
+
+
+/* the writer side. init publishes the hull of points as the first
+   version; insert adds points and publishes the new hull. when the
+   batch is large compared to the hull it is rebuilt from its vertices
+   and the batch, else the points outside are inserted one by one.
+   until the points span 3 dimensions the versions have no faces */
+void versioned_hull_init(versioned_hull *vh, vector<point3d> &points);
+void versioned_hull_insert(versioned_hull *vh, vector<point3d> &batch);
+
+/* free the replaced versions that no reader can still see; called by
+   versioned_hull_insert(). returns the number still kept */
+int versioned_hull_reclaim(versioned_hull *vh);
+
+/* free every version. no reader may be using the hull */
+void versioned_hull_free(versioned_hull *vh);
+
+
+/* the reader side. a thread takes a reader slot once, and returns -1
+   if they are all taken */
+int versioned_hull_reader(versioned_hull *vh);
+void versioned_hull_release(versioned_hull *vh, int reader);
+
+/* a snapshot of the current version, valid until the reader leaves.
+   enter and leave are a few atomic loads and stores, and never wait
+   for the writer */
+const hull_version *versioned_hull_enter(versioned_hull *vh, int reader);
+void versioned_hull_leave(versioned_hull *vh, int reader);
+
+/* return 1 if p is inside or on the hull of the snapshot, 0 otherwise
+   (always 0 while the hull has no faces). exact */
+int hull_version_contains(const hull_version *v, point3d p);
+
+/* enter, hull_version_contains() on the current version, leave */
+int versioned_hull_contains(versioned_hull *vh, int reader, point3d p);
+
+#endif
@@ -0,0 +1,249 @@
+/*  incremental.cpp
+ *
+ *  randomized incremental convex hull with conflict lists.
+ *
+ *  every point that is not inserted yet is either known to be inside
+ *  the current hull or remembers one face it is strictly outside of.
+ *  inserting a point replaces the faces it sees (hull_mesh_insert), and
+ *  only the points that remembered one of those faces are tested
+ *  again, against the new faces. in random order the expected running
+ *  time is O(n log n).
+ *
+ */
+
+
+#include "incremental.h"
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+/* the corners of face f of the mesh */
+#define CORNER(f, i) points[mesh->vert[mesh->face[3*(f)+(i)]]]
+
+
+/* find 4 points that are not on a plane, as positions in ids, trying
+   to make the tetrahedron large so that it swallows many points.
+   returns 0 if all the points are on a plane */
+static int initial_simplex(vector<point3d> &points, vector<int> &ids, int s[4]) {
+
+  int m = ids.size();
+  if (m < 4) return 0;
+
+  //the points with smallest and largest x, else any two distinct ones
+  s[0] = s[1] = 0;
+  for (int k = 1; k < m; k++) {
+    if (points[ids[k]].x < points[ids[s[0]]].x) s[0] = k;
+    if (points[ids[k]].x > points[ids[s[1]]].x) s[1] = k;
+  }
+  for (int k = 0; k < m && isEqual(points[ids[s[0]]], points[ids[s[1]]]); k++) s[1] = k;
+  if (isEqual(points[ids[s[0]]], points[ids[s[1]]])) return 0;
+
+  //the point furthest from the line s0 s1
+  point3d a = points[ids[s[0]]], b = points[ids[s[1]]];
+  double ux = (double)b.x - a.x, uy = (double)b.y - a.y, uz = (double)b.z - a.z;
+  double best = -1;
+  s[2] = -1;
+  for (int k = 0; k < m; k++) {
+    point3d &p = points[ids[k]];
+    double vx = (double)p.x - a.x, vy = (double)p.y - a.y, vz = (double)p.z - a.z;
+    double cx = uy*vz - uz*vy, cy = uz*vx - ux*vz, cz = ux*vy - uy*vx;
+    double d = cx*cx + cy*cy + cz*cz;
+    if (d > best && !on_line(a, b, p)) {
+      best = d;
+      s[2] = k;
+    }
+  }
+  if (s[2] < 0) return 0;
+
+  //the point furthest from the plane s0 s1 s2
+  point3d c = points[ids[s[2]]];
+  double vx = (double)c.x - a.x, vy = (double)c.y - a.y, vz = (double)c.z - a.z;
+  double nx = uy*vz - uz*vy, ny = uz*vx - ux*vz, nz = ux*vy - uy*vx;
+  best = -1;
+  s[3] = -1;
+  for (int k = 0; k < m; k++) {
+    point3d &p = points[ids[k]];
+    double d = fabs(nx*((double)p.x - a.x) + ny*((double)p.y - a.y) + nz*((double)p.z - a.z));
+    if (d > best && volume_sign(a, b, c, p) != 0) {
+      best = d;
+      s[3] = k;
+    }
+  }
+  return s[3] >= 0;
+}
+
+
+void incremental_hull_mesh(vector<point3d> &points, vector<int> &ids, hull_mesh *mesh) {
+
+  mesh->vert.clear();
+  mesh->face.clear();
+  mesh->nbr.clear();
+  mesh->vfirst.clear();
+  mesh->vadj.clear();
+  mesh->free.clear();
+  mesh->seen.clear();
+  mesh->visit = 0;
+
+  int s[4];
+  if (!initial_simplex(points, ids, s)) return;
+
+  //the tetrahedron, oriented so that vertex 3 is on the inner side of
+  //face 012 like in brute_force_hull; the other faces follow
+  if (volume_sign(points[ids[s[0]]], points[ids[s[1]]], points[ids[s[2]]], points[ids[s[3]]]) > 0) {
+    swap(s[1], s[2]);
+  }
+  int tet[4][3] = {{0,1,2}, {1,0,3}, {2,1,3}, {0,2,3}};
+  for (int k = 0; k < 4; k++) mesh->vert.push_back(ids[s[k]]);
+  for (int f = 0; f < 4; f++) {
+    for (int i = 0; i < 3; i++) mesh->face.push_back(tet[f][i]);
+  }
+  mesh->nbr.resize(12);
+  for (int f = 0; f < 4; f++) {
+    for (int i = 0; i < 3; i++) {
+      int u = tet[f][i], v = tet[f][(i+1)%3];
+      for (int g = 0; g < 4; g++) {
+        for (int j = 0; j < 3; j++) {
+          if (tet[g][j] == v && tet[g][(j+1)%3] == u) mesh->nbr[3*f+i] = g;
+        }
+      }
+    }
+  }
+  mesh->seen.assign(4, 0);
+
+  //give every other point a face it is outside of, if any
+  int m = ids.size();
+  vector<int> pface(m, -1);
+  vector<vector<int> > conflict(4);
+  for (int k = 0; k < m; k++) {
+    if (k == s[0] || k == s[1] || k == s[2] || k == s[3]) continue;
+    point3d &p = points[ids[k]];
+    for (int f = 0; f < 4; f++) {
+      if (volume_sign(CORNER(f, 0), CORNER(f, 1), CORNER(f, 2), p) > 0) {
+        pface[k] = f;
+        conflict[f].push_back(k);
+        break;
+      }
+    }
+  }
+
+  //a fixed shuffle (xorshift), so that the hull does not depend on
+  //the state of random()
+  vector<int> order(m);
+  for (int k = 0; k < m; k++) order[k] = k;
+  unsigned long long state = 0x2545F4914F6CDD1DULL;
+  for (int k = m - 1; k > 0; k--) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    swap(order[k], order[state % (k + 1)]);
+  }
+
+  vector<int> added, removed, orphans;
+  for (int t = 0; t < m; t++) {
+    int k = order[t];
+    if (pface[k] < 0) continue;
+
+    added.clear();
+    removed.clear();
+    hull_mesh_insert(points, mesh, ids[k], pface[k], &added, &removed, NULL);
+    pface[k] = -1;
+
+    //take the points of the removed faces before their slots are
+    //reused, and hand them to the new faces
+    orphans.clear();
+    for (size_t r = 0; r < removed.size(); r++) {
+      orphans.insert(orphans.end(), conflict[removed[r]].begin(), conflict[removed[r]].end());
+      conflict[removed[r]].clear();
+    }
+    conflict.resize(mesh->face.size() / 3);
+    for (size_t o = 0; o < orphans.size(); o++) {
+      int q = orphans[o];
+      if (pface[q] < 0) continue;
+      pface[q] = -1;
+      for (size_t a = 0; a < added.size(); a++) {
+        int f = added[a];
+        if (volume_sign(CORNER(f, 0), CORNER(f, 1), CORNER(f, 2), points[ids[q]]) > 0) {
+          pface[q] = f;
+          conflict[f].push_back(q);
+          break;
+        }
+      }
+    }
+  }
+}
+
+
+vector<triangle3d> incremental_hull(vector<point3d> &points) {
+
+  vector<int> ids(points.size());
+  for (size_t i = 0; i < points.size(); i++) ids[i] = i;
+
+  hull_mesh mesh;
+  incremental_hull_mesh(points, ids, &mesh);
+
+  vector<triangle3d> result;
+  hull_mesh_faces(points, &mesh, result);
+  return result;
+}
+
+
+/* the hull vertices of the points ids[lo..hi), into verts */
+static void chunk_vertices(vector<point3d> *points, vector<int> *ids, size_t lo, size_t hi,
+                           vector<int> *verts) {
+
+  vector<int> part(ids->begin() + lo, ids->begin() + hi);
+  hull_mesh mesh;
+  incremental_hull_mesh(*points, part, &mesh);
+  if (mesh.face.size() == 0) {
+    //flat: keep all of them
+    *verts = part;
+    return;
+  }
+  verts->clear();
+  for (size_t f = 0; f < mesh.face.size() / 3; f++) {
+    if (mesh.face[3*f] == DEAD_FACE) continue;
+    for (int i = 0; i < 3; i++) verts->push_back(mesh.vert[mesh.face[3*f+i]]);
+  }
+  sort(verts->begin(), verts->end());
+  verts->erase(unique(verts->begin(), verts->end()), verts->end());
+}
+
+
+vector<triangle3d> parallel_hull(vector<point3d> &points, int nthreads) {
+
+  if (nthreads <= 0) nthreads = thread::hardware_concurrency();
+  if (nthreads <= 0) nthreads = 1;
+
+  vector<int> ids(points.size());
+  for (size_t i = 0; i < points.size(); i++) ids[i] = i;
+
+  //the hulls of the chunks, one per thread
+  vector<vector<int> > verts(nthreads);
+  size_t chunk = (ids.size() + nthreads - 1) / nthreads;
+  vector<thread> workers;
+  for (int t = 0; t < nthreads; t++) {
+    size_t from = min(ids.size(), t * chunk), to = min(ids.size(), from + chunk);
+    workers.push_back(thread(chunk_vertices, &points, &ids, from, to, &verts[t]));
+  }
+  for (int t = 0; t < nthreads; t++) workers[t].join();
+
+  //and the hull of their vertices
+  ids.clear();
+  for (int t = 0; t < nthreads; t++) ids.insert(ids.end(), verts[t].begin(), verts[t].end());
+  hull_mesh mesh;
+  incremental_hull_mesh(points, ids, &mesh);
+
+  vector<triangle3d> result;
+  hull_mesh_faces(points, &mesh, result);
+  return result;
+}
+
+
+vector<triangle3d> parallel_hull(vector<point3d> &points) {
+  return parallel_hull(points, 0);
+}
@@ -0,0 +1,34 @@
+#ifndef __incremental_h
+#define __incremental_h
+
+#include "geom.h"
+#include "hullmesh.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* compute the hull of the points points[ids[i]] into mesh, inserting
+   the points in random order. every point not yet inserted remembers
+   one face it is outside of, so each insertion only looks at the faces
+   it replaces. mesh is left in its edited form (see hullmesh.h). if the
+   points are all on a plane the mesh has no faces */
+void incremental_hull_mesh(vector<point3d> &points, vector<int> &ids, hull_mesh *mesh);
+
+/* compute and return the convex hull of the points, as brute_force_hull
+   does. handles coplanar, collinear and duplicated points */
+vector<triangle3d> incremental_hull(vector<point3d> &points);
+
+/* the same, with the points split in nthreads chunks (0 means one per
+   core) whose hulls are computed in parallel. the hull of the chunk
+   hull vertices is the hull of the points */
+vector<triangle3d> parallel_hull(vector<point3d> &points, int nthreads);
+
+/* parallel_hull() with one thread per core, with the signature of
+   brute_force_hull() */
+vector<triangle3d> parallel_hull(vector<point3d> &points);
+
+#endif
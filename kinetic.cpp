@@ -0,0 +1,312 @@
+/*  kinetic.cpp
+ *
+ *  frame to frame hull updates for moving points.
+ *
+ *  if every hull vertex moves by at most d, the new hull still contains
+ *  every point whose distance to the old boundary was more than d. so
+ *  an interior point only needs to be looked at once the distance it
+ *  moved plus the drift of the hull vertices has eaten its margin.
+ *  edges of the hull that became reflex are flipped, points that came
+ *  out of the hull are inserted, and if the flips cascade the hull is
+ *  rebuilt from its own vertices plus the failed points, never from
+ *  all n points.
+ *
+ */
+
+
+#include "kinetic.h"
+#include "incremental.h"
+#include <stdio.h>
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+
+//flips per step before rebuilding instead
+const int MAX_FLIPS = 64;
+
+/* the corners of face f of the mesh */
+#define CORNER(f, i) points[mesh->vert[mesh->face[3*(f)+(i)]]]
+
+
+/* new certificates for the interior points in ids: their distance to
+   the closest face plane, less a bound on the rounding error */
+static void certify_points(kinetic_hull *k, vector<int> &ids) {
+
+  vector<point3d> &points = *k->points;
+  hull_mesh *mesh = &k->mesh;
+  if (ids.size() == 0) return;
+
+  //unit inward normals of the live faces
+  vector<double> plane;
+  vector<int> corner;
+  int nf = mesh->face.size() / 3;
+  for (int f = 0; f < nf; f++) {
+    if (mesh->face[3*f] == DEAD_FACE) continue;
+    point3d &a = CORNER(f, 0), &b = CORNER(f, 1), &c = CORNER(f, 2);
+    double ux = (double)b.x - a.x, uy = (double)b.y - a.y, uz = (double)b.z - a.z;
+    double vx = (double)c.x - a.x, vy = (double)c.y - a.y, vz = (double)c.z - a.z;
+    double nx = uy*vz - uz*vy, ny = uz*vx - ux*vz, nz = ux*vy - uy*vx;
+    double len = sqrt(nx*nx + ny*ny + nz*nz);
+    if (len == 0) continue;
+    plane.push_back(nx / len);
+    plane.push_back(ny / len);
+    plane.push_back(nz / len);
+    corner.push_back(mesh->vert[mesh->face[3*f]]);
+  }
+
+  for (size_t i = 0; i < ids.size(); i++) {
+    point3d &p = points[ids[i]];
+    double margin = DBL_MAX;
+    for (size_t f = 0; f < corner.size(); f++) {
+      point3d &a = points[corner[f]];
+      double dx = (double)p.x - a.x, dy = (double)p.y - a.y, dz = (double)p.z - a.z;
+      double d = plane[3*f]*dx + plane[3*f+1]*dy + plane[3*f+2]*dz;
+      margin = min(margin, d - 1e-12 * (fabs(dx) + fabs(dy) + fabs(dz)));
+    }
+    if (corner.size() == 0) margin = 0;
+    k->slack[ids[i]] = margin + k->drift;
+  }
+}
+
+
+/* remember a live face of every mesh vertex, and a point in the middle
+   of the hull: the mean of the face corners */
+static void index_faces(kinetic_hull *k) {
+
+  vector<point3d> &points = *k->points;
+  hull_mesh *mesh = &k->mesh;
+  int nf = mesh->face.size() / 3;
+  double sum[3] = {0, 0, 0};
+  int nv = 0;
+  k->vface.assign(mesh->vert.size(), -1);
+  for (int f = 0; f < nf; f++) {
+    if (mesh->face[3*f] == DEAD_FACE) continue;
+    for (int i = 0; i < 3; i++) {
+      k->vface[mesh->face[3*f+i]] = f;
+      sum[0] += CORNER(f, i).x;
+      sum[1] += CORNER(f, i).y;
+      sum[2] += CORNER(f, i).z;
+      nv++;
+    }
+  }
+  point3d mid = {0, 0, 0};
+  if (nv > 0) {
+    mid.x = (int)floor(sum[0] / nv + 0.5);
+    mid.y = (int)floor(sum[1] / nv + 0.5);
+    mid.z = (int)floor(sum[2] / nv + 0.5);
+  }
+  k->center = mid;
+}
+
+
+/* mark face f for repair_edges() */
+static void touch_face(hull_mesh *mesh, int f, int mark, vector<int> &faces) {
+  if (mesh->seen[f] == mark) return;
+  mesh->seen[f] = mark;
+  faces.push_back(f);
+}
+
+/* check the convexity of the edges around the mesh vertices in moved,
+   the only ones whose certificates can have failed, and flip the
+   reflex ones. returns 0 if a face collapsed, a flip was impossible or
+   there were too many. flips only see one edge at a time, and a step
+   that moved the points a lot can leave faces folded over each other
+   with every edge convex; so every face that moved or was flipped must
+   also still face k->center, else the repair is given up as well. the
+   other faces have not changed and faced it before */
+static int repair_edges(kinetic_hull *k, vector<int> &moved) {
+
+  vector<point3d> &points = *k->points;
+  hull_mesh *mesh = &k->mesh;
+  mesh->seen.resize(mesh->face.size() / 3, 0);
+  int mark = ++mesh->visit;
+
+  //the faces around the moved vertices
+  vector<int> faces;
+  for (size_t m = 0; m < moved.size(); m++) {
+    int v = moved[m], start = k->vface[v], cur = start, steps = 0;
+    if (start < 0 || mesh->face[3*start] == DEAD_FACE) continue;
+    do {
+      int i = 0;
+      while (i < 3 && mesh->face[3*cur+i] != v) i++;
+      if (i == 3) break;   //a stale vertex that left the hull
+      touch_face(mesh, cur, mark, faces);
+      cur = mesh->nbr[3*cur+i];
+    } while (cur != start && ++steps < (int)mesh->face.size());
+  }
+
+  vector<int> stack;
+  for (size_t t = 0; t < faces.size(); t++) {
+    int f = faces[t];
+    if (on_line(CORNER(f, 0), CORNER(f, 1), CORNER(f, 2))) return 0;
+    for (int i = 0; i < 3; i++) stack.push_back(3*f+i);
+  }
+
+  while (stack.size() > 0) {
+    int e = stack.back();
+    stack.pop_back();
+    int f = e / 3, g = mesh->nbr[e];
+
+    //the corner of g that is not on the edge
+    int u = mesh->face[e], v = mesh->face[3*f + (e%3 + 1) % 3], j = 0;
+    while (mesh->face[3*g+j] == u || mesh->face[3*g+j] == v) j++;
+    if (volume_sign(CORNER(f, 0), CORNER(f, 1), CORNER(f, 2), CORNER(g, j)) <= 0) continue;
+
+    if (k->flips >= k->max_flips || !hull_mesh_flip(mesh, e)) return 0;
+    k->flips++;
+    if (on_line(CORNER(f, 0), CORNER(f, 1), CORNER(f, 2)) ||
+        on_line(CORNER(g, 0), CORNER(g, 1), CORNER(g, 2))) return 0;
+    touch_face(mesh, f, mark, faces);
+    touch_face(mesh, g, mark, faces);
+    for (int i = 0; i < 3; i++) {
+      k->vface[mesh->face[3*f+i]] = f;
+      k->vface[mesh->face[3*g+i]] = g;
+      stack.push_back(3*f+i);
+      stack.push_back(3*g+i);
+    }
+  }
+
+  //with every edge convex and every face facing the center, the
+  //surface wraps it exactly once
+  k->checked = faces.size();
+  for (size_t t = 0; t < faces.size(); t++) {
+    int f = faces[t];
+    if (volume_sign(CORNER(f, 0), CORNER(f, 1), CORNER(f, 2), k->center) >= 0) return 0;
+  }
+  return 1;
+}
+
+
+void kinetic_hull_init(kinetic_hull *k, vector<point3d> *points) {
+
+  int n = points->size();
+  k->points = points;
+  k->drift = 0;
+  k->max_flips = MAX_FLIPS;
+  k->failures = k->flips = k->inserted = k->rebuilt = k->checked = 0;
+
+  vector<int> ids(n);
+  for (int i = 0; i < n; i++) ids[i] = i;
+  incremental_hull_mesh(*points, ids, &k->mesh);
+  hull_mesh_faces(*points, &k->mesh, k->hull);
+  index_faces(k);
+
+  k->on_hull.assign(n, 0);
+  for (size_t f = 0; f < k->hull.size(); f++) {
+    k->on_hull[k->hull[f].a - &(*points)[0]] = 1;
+    k->on_hull[k->hull[f].b - &(*points)[0]] = 1;
+    k->on_hull[k->hull[f].c - &(*points)[0]] = 1;
+  }
+
+  k->slack.assign(n, 0);
+  vector<int> inside;
+  for (int i = 0; i < n; i++) {
+    if (!k->on_hull[i]) inside.push_back(i);
+  }
+  certify_points(k, inside);
+}
+
+
+void kinetic_hull_step(kinetic_hull *k, vector<point3d> &disp) {
+
+  vector<point3d> &points = *k->points;
+  int n = points.size();
+  k->failures = k->flips = k->inserted = k->rebuilt = k->checked = 0;
+
+  //move the points. the faces moved at most as far as the fastest
+  //hull vertex, the interior points use up their slack
+  double step = 0;
+  for (int i = 0; i < n; i++) {
+    double d = sqrt((double)disp[i].x*disp[i].x + (double)disp[i].y*disp[i].y +
+                    (double)disp[i].z*disp[i].z);
+    points[i].x += disp[i].x;
+    points[i].y += disp[i].y;
+    points[i].z += disp[i].z;
+    if (k->on_hull[i]) {
+      step = max(step, d);
+    } else {
+      k->slack[i] -= d;
+    }
+  }
+  k->drift += step;
+
+  vector<int> failed;
+  for (int i = 0; i < n; i++) {
+    if (!k->on_hull[i] && k->slack[i] <= k->drift) failed.push_back(i);
+  }
+  k->failures = failed.size();
+
+  //the points that need a new certificate
+  vector<int> recheck;
+
+  //the hull vertices that moved
+  vector<int> moved;
+  for (size_t v = 0; v < k->mesh.vert.size(); v++) {
+    point3d &d = disp[k->mesh.vert[v]];
+    if (k->on_hull[k->mesh.vert[v]] && (d.x != 0 || d.y != 0 || d.z != 0)) moved.push_back(v);
+  }
+
+  int repaired = (k->mesh.face.size() > 0) && repair_edges(k, moved);
+  if (repaired) {
+    //the hull is convex again; the failed points are either still
+    //inside or are added to it
+    vector<int> gone, added;
+    for (size_t i = 0; i < failed.size(); i++) {
+      int f = hull_mesh_outside(points, &k->mesh, points[failed[i]]);
+      if (f < 0) {
+        recheck.push_back(failed[i]);
+        continue;
+      }
+      added.clear();
+      hull_mesh_insert(points, &k->mesh, failed[i], f, &added, NULL, &gone);
+      k->vface.resize(k->mesh.vert.size(), -1);
+      for (size_t a = 0; a < added.size(); a++) {
+        for (int j = 0; j < 3; j++) k->vface[k->mesh.face[3*added[a]+j]] = added[a];
+      }
+      k->on_hull[failed[i]] = 1;
+      k->inserted++;
+    }
+    for (size_t i = 0; i < gone.size(); i++) {
+      if (k->on_hull[gone[i]]) {
+        k->on_hull[gone[i]] = 0;
+        recheck.push_back(gone[i]);
+      }
+    }
+  } else {
+    //rebuild from the hull vertices and the failed points; every other
+    //point is still certified to be inside
+    k->rebuilt = 1;
+    vector<int> ids(failed);
+    hull_mesh *mesh = &k->mesh;
+    for (size_t f = 0; f < mesh->face.size() / 3; f++) {
+      if (mesh->face[3*f] == DEAD_FACE) continue;
+      for (int i = 0; i < 3; i++) ids.push_back(mesh->vert[mesh->face[3*f+i]]);
+    }
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    if (ids.size() == 0) {
+      //no hull yet (flat points): start over
+      kinetic_hull_init(k, k->points);
+      k->rebuilt = 1;
+      return;
+    }
+    incremental_hull_mesh(points, ids, mesh);
+    index_faces(k);
+
+    for (size_t i = 0; i < ids.size(); i++) k->on_hull[ids[i]] = 0;
+    for (size_t f = 0; f < mesh->face.size() / 3; f++) {
+      if (mesh->face[3*f] == DEAD_FACE) continue;
+      for (int i = 0; i < 3; i++) k->on_hull[mesh->vert[mesh->face[3*f+i]]] = 1;
+    }
+    for (size_t i = 0; i < ids.size(); i++) {
+      if (!k->on_hull[ids[i]]) recheck.push_back(ids[i]);
+    }
+  }
+
+  certify_points(k, recheck);
+  hull_mesh_faces(points, &k->mesh, k->hull);
+}
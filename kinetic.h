@@ -0,0 +1,56 @@
+#ifndef __kinetic_h
+#define __kinetic_h
+
+#include "geom.h"
+#include "hullmesh.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* a hull kept up to date while its points move a little at a time.
+
+   two kinds of certificates say that the hull is still right:
+   - every edge of the hull is convex: the sign of the signed volume of
+     a face and the far corner of its neighbour has not flipped
+   - every interior point is further from the hull boundary than the
+     distance it and the hull vertices have moved since it was last
+     checked (its slack)
+   a step only looks at the edges around the hull vertices that moved
+   and at the interior points whose certificates failed */
+typedef struct _kinetic_hull {
+  vector<point3d> *points;   //moved in place by kinetic_hull_step()
+  hull_mesh mesh;            //the current hull, in edited form
+  vector<triangle3d> hull;   //its faces, rebuilt after every step
+  vector<char> on_hull;      //1 for the points that are hull vertices
+  vector<double> slack;      //the point is inside while slack > drift
+  double drift;              //bound on how far any hull vertex has moved
+  int max_flips;             //flips per step before rebuilding instead
+  vector<int> vface;         //a live face of each mesh vertex
+  point3d center;            //a point inside the hull that every face faces
+
+  //what the last step did
+  int failures;              //interior points whose certificate failed
+  int flips;                 //reflex edges flipped
+  int inserted;              //points that came out of the hull
+  int rebuilt;               //1 if the repairs gave up and the hull was rebuilt
+  int checked;               //faces whose edges were checked
+} kinetic_hull;
+
+
+/* compute the hull of the points and the certificates of all of them */
+void kinetic_hull_init(kinetic_hull *k, vector<point3d> *points);
+
+/* move every point i by disp[i] and repair the hull. reading disp is
+   O(n). the edge checks and flips only cover the faces around the hull
+   vertices that moved, and each interior point whose certificate failed
+   costs one pass over the faces, to find out if it came out and to
+   certify it again. the faces are then copied out to k->hull. when
+   repairs cascade, the hull is rebuilt from its vertices and the points
+   whose certificates failed only */
+void kinetic_hull_step(kinetic_hull *k, vector<point3d> &disp);
+
+#endif
@@ -0,0 +1,253 @@
+/*  lod.cpp
+ *
+ *  coarser convex hulls that contain a hull, for drawing and sending
+ *  it with fewer faces.
+ *
+ *  a k-DOP is cut from a box around the points by clipping it with one
+ *  plane after the other. its faces are kept as convex polygons in
+ *  doubles; only its corners are used in the end, rounded to integers,
+ *  and the level is their hull.
+ *
+ *  a plane pushed out by 1 past the points still contains them after
+ *  the corners move by up to sqrt(3)/2 when they are rounded: in every
+ *  direction the hull of the moved corners reaches at most sqrt(3)/2
+ *  less far than the DOP, which is still past the points.
+ *
+ */
+
+
+#include "lod.h"
+#include "hullmetrics.h"
+#include "incremental.h"
+#include <math.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+using namespace std;
+
+
+//the finest k-DOP tried has 10 * 4^MAX_LOD_LEVEL + 2 directions
+const int MAX_LOD_LEVEL = 4;
+
+
+void sphere_directions(int level, vector<double> &dirs) {
+
+  double t = (1 + sqrt(5.0)) / 2;
+  double ico[12][3] = {{-1, t, 0}, {1, t, 0}, {-1, -t, 0}, {1, -t, 0},
+                       {0, -1, t}, {0, 1, t}, {0, -1, -t}, {0, 1, -t},
+                       {t, 0, -1}, {t, 0, 1}, {-t, 0, -1}, {-t, 0, 1}};
+  int tri[20][3] = {{0, 11, 5}, {0, 5, 1}, {0, 1, 7}, {0, 7, 10}, {0, 10, 11},
+                    {1, 5, 9}, {5, 11, 4}, {11, 10, 2}, {10, 7, 6}, {7, 1, 8},
+                    {3, 9, 4}, {3, 4, 2}, {3, 2, 6}, {3, 6, 8}, {3, 8, 9},
+                    {4, 9, 5}, {2, 4, 11}, {6, 2, 10}, {8, 6, 7}, {9, 8, 1}};
+
+  dirs.clear();
+  for (int v = 0; v < 12; v++) {
+    double len = sqrt(1 + t*t);
+    for (int i = 0; i < 3; i++) dirs.push_back(ico[v][i] / len);
+  }
+  vector<int> faces(&tri[0][0], &tri[0][0] + 60);
+
+  for (int l = 0; l < level; l++) {
+    //a new direction at the middle of every edge, and 4 triangles
+    //for each old one
+    map<pair<int, int>, int> middle;
+    vector<int> finer;
+    for (size_t f = 0; f < faces.size(); f += 3) {
+      int m[3];
+      for (int i = 0; i < 3; i++) {
+        int a = faces[f+i], b = faces[f+(i+1)%3];
+        pair<int, int> e(min(a, b), max(a, b));
+        if (middle.find(e) == middle.end()) {
+          double c[3], len = 0;
+          for (int j = 0; j < 3; j++) {
+            c[j] = dirs[3*a+j] + dirs[3*b+j];
+            len += c[j] * c[j];
+          }
+          middle[e] = dirs.size() / 3;
+          for (int j = 0; j < 3; j++) dirs.push_back(c[j] / sqrt(len));
+        }
+        m[i] = middle[e];
+      }
+      int sub[12] = {faces[f], m[0], m[2], faces[f+1], m[1], m[0],
+                     faces[f+2], m[2], m[1], m[0], m[1], m[2]};
+      finer.insert(finer.end(), sub, sub + 12);
+    }
+    faces = finer;
+  }
+}
+
+
+/* keep the part of the polytope with n . x <= c. every face is a
+   convex polygon, 3 doubles per corner */
+static void clip_polytope(vector<vector<double> > &faces, const double n[3], double c) {
+
+  vector<vector<double> > kept;
+  vector<double> cut;
+  for (size_t f = 0; f < faces.size(); f++) {
+    vector<double> &poly = faces[f];
+    vector<double> out;
+    int m = poly.size() / 3;
+    for (int i = 0; i < m; i++) {
+      double *p = &poly[3*i], *q = &poly[3*((i+1)%m)];
+      double dp = n[0]*p[0] + n[1]*p[1] + n[2]*p[2] - c;
+      double dq = n[0]*q[0] + n[1]*q[1] + n[2]*q[2] - c;
+      if (dp <= 0) out.insert(out.end(), p, p + 3);
+      if (dp == 0) cut.insert(cut.end(), p, p + 3);
+      if ((dp < 0 && dq > 0) || (dp > 0 && dq < 0)) {
+        double s = dp / (dp - dq), x[3];
+        for (int j = 0; j < 3; j++) x[j] = p[j] + s * (q[j] - p[j]);
+        out.insert(out.end(), x, x + 3);
+        cut.insert(cut.end(), x, x + 3);
+      }
+    }
+    if (out.size() >= 9) kept.push_back(out);
+  }
+
+  //the new face: the cut points in order around their center
+  int m = cut.size() / 3;
+  if (m >= 3) {
+    double center[3] = {0, 0, 0}, u[3], v[3];
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < 3; j++) center[j] += cut[3*i+j] / m;
+    }
+    int axis = (fabs(n[0]) < fabs(n[1])) ? 0 : 1;
+    if (fabs(n[2]) < fabs(n[axis])) axis = 2;
+    double e[3] = {0, 0, 0};
+    e[axis] = 1;
+    u[0] = n[1]*e[2] - n[2]*e[1];
+    u[1] = n[2]*e[0] - n[0]*e[2];
+    u[2] = n[0]*e[1] - n[1]*e[0];
+    v[0] = n[1]*u[2] - n[2]*u[1];
+    v[1] = n[2]*u[0] - n[0]*u[2];
+    v[2] = n[0]*u[1] - n[1]*u[0];
+    vector<pair<double, int> > angle(m);
+    for (int i = 0; i < m; i++) {
+      double d[3] = {cut[3*i] - center[0], cut[3*i+1] - center[1], cut[3*i+2] - center[2]};
+      angle[i] = make_pair(atan2(d[0]*v[0] + d[1]*v[1] + d[2]*v[2],
+                                 d[0]*u[0] + d[1]*u[1] + d[2]*u[2]), i);
+    }
+    sort(angle.begin(), angle.end());
+    vector<double> cap;
+    for (int i = 0; i < m; i++) {
+      double *p = &cut[3*angle[i].second];
+      cap.insert(cap.end(), p, p + 3);
+    }
+    kept.push_back(cap);
+  }
+  faces = kept;
+}
+
+
+/* the corners of the k-DOP of the points in the first k directions,
+   pushed out by 1 and rounded to integers */
+static void kdop_corners(vector<point3d> &points, vector<double> &dirs, int k,
+                         vector<point3d> &corners) {
+
+  //a box 2 past the points
+  double lo[3] = {1e300, 1e300, 1e300}, hi[3] = {-1e300, -1e300, -1e300};
+  for (size_t i = 0; i < points.size(); i++) {
+    double c[3] = {(double)points[i].x, (double)points[i].y, (double)points[i].z};
+    for (int j = 0; j < 3; j++) {
+      lo[j] = min(lo[j], c[j] - 2);
+      hi[j] = max(hi[j], c[j] + 2);
+    }
+  }
+  vector<vector<double> > faces;
+  for (int axis = 0; axis < 3; axis++) {
+    for (int side = 0; side < 2; side++) {
+      int a = (axis + 1) % 3, b = (axis + 2) % 3;
+      double square[4][2] = {{lo[a], lo[b]}, {hi[a], lo[b]}, {hi[a], hi[b]}, {lo[a], hi[b]}};
+      vector<double> poly(12);
+      for (int i = 0; i < 4; i++) {
+        poly[3*i + axis] = side ? hi[axis] : lo[axis];
+        poly[3*i + a] = square[i][0];
+        poly[3*i + b] = square[i][1];
+      }
+      faces.push_back(poly);
+    }
+  }
+
+  for (int d = 0; d < k; d++) {
+    const double *n = &dirs[3*d];
+    double h = -1e300;
+    for (size_t i = 0; i < points.size(); i++) {
+      h = max(h, n[0] * points[i].x + n[1] * points[i].y + n[2] * points[i].z);
+    }
+    clip_polytope(faces, n, h + 1);
+  }
+
+  corners.clear();
+  for (size_t f = 0; f < faces.size(); f++) {
+    for (size_t i = 0; i < faces[f].size(); i += 3) {
+      point3d p = {(int)lround(faces[f][i]), (int)lround(faces[f][i+1]),
+                   (int)lround(faces[f][i+2])};
+      corners.push_back(p);
+    }
+  }
+}
+
+
+static bool point_less(const point3d &a, const point3d &b) {
+  if (a.x != b.x) return a.x < b.x;
+  if (a.y != b.y) return a.y < b.y;
+  return a.z < b.z;
+}
+
+static double hull_volume(hull_data *data) {
+
+  vector<triangle3d> faces;
+  hull_data_triangles(data, faces);
+  hull_metrics m;
+  compute_hull_metrics(faces, &m, 1);
+  return fabs(m.volume);
+}
+
+
+void build_hull_lod(vector<triangle3d> &hull, vector<hull_level> &levels) {
+
+  levels.clear();
+  hull_level top;
+  hull_data_from_faces(hull, &top.hull);
+  top.directions = 0;
+  top.volume = hull_volume(&top.hull);
+  top.error = 0;
+
+  //from the finest DOP to the coarsest, each cut around the last
+  vector<point3d> finer = top.hull.vertex;
+  vector<double> dirs;
+  sphere_directions(MAX_LOD_LEVEL, dirs);
+  for (int l = MAX_LOD_LEVEL; l >= 0 && top.volume > 0; l--) {
+    int k = 10 * (1 << (2*l)) + 2;
+    //a k-DOP has at most 2k - 4 corners
+    if (2*k - 4 >= (int)finer.size() / 2) continue;
+
+    vector<point3d> corners;
+    kdop_corners(finer, dirs, k, corners);
+    sort(corners.begin(), corners.end(), point_less);
+    corners.erase(unique(corners.begin(), corners.end(), isEqual), corners.end());
+    if (corners.size() >= finer.size() / 2) continue;
+
+    hull_level level;
+    vector<triangle3d> faces = incremental_hull(corners);
+    hull_data_from_faces(faces, &level.hull);
+    level.directions = k;
+    level.volume = hull_volume(&level.hull);
+    level.error = (level.volume - top.volume) / top.volume;
+    levels.push_back(level);
+    finer = level.hull.vertex;
+  }
+
+  reverse(levels.begin(), levels.end());
+  levels.push_back(top);
+}
+
+
+int choose_hull_level(vector<hull_level> &levels, double max_error) {
+
+  for (size_t l = 0; l + 1 < levels.size(); l++) {
+    if (levels[l].error <= max_error) return l;
+  }
+  return (int)levels.size() - 1;
+}
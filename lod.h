@@ -0,0 +1,41 @@
+#ifndef __lod_h
+#define __lod_h
+
+#include "geom.h"
+#include "hullcodec.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* one level of detail of a hull. every level contains the next one,
+   and the last level is the hull itself */
+typedef struct _hull_level {
+  hull_data hull;     //vertices and faces (hullcodec.h)
+  int directions;     //planes of the k-DOP it was cut from; 0 for the hull itself
+  double volume;
+  double error;       //extra volume, relative to the volume of the hull
+} hull_level;
+
+
+/* the levels of detail of a hull, coarsest first. each coarse level
+   is a k-DOP: the intersection of the half-spaces bounding the next
+   finer level in k directions spread evenly on the sphere (the
+   vertices of subdivided icosahedra, 12, 42, 162, ...), pushed out by
+   1 so that it still contains the finer level once its corners are
+   rounded to integers. only the DOPs with fewer vertices than half
+   the next finer level are kept */
+void build_hull_lod(vector<triangle3d> &hull, vector<hull_level> &levels);
+
+/* the index of the coarsest level whose error is at most max_error */
+int choose_hull_level(vector<hull_level> &levels, double max_error);
+
+/* the k directions of the k-DOPs: level 0 is the 12 vertices of an
+   icosahedron, and every level keeps the directions of the previous
+   one and adds the midpoints of its edges */
+void sphere_directions(int level, vector<double> &dirs);
+
+#endif
@@ -0,0 +1,592 @@
+/*  obb.cpp
+ *
+ *  oriented bounding boxes fitted on a hull. all variants only look at
+ *  the hull vertices and its adjacency, never at the interior points.
+ *  obb_sampled() approaches the optimal box of O'Rourke's edge pair
+ *  method by sampling the arcs it searches, obb_exact() follows each arc
+ *  from one set of touching vertices to the next and minimizes the
+ *  volume in between.
+ *
+ */
+
+
+#include "obb.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+static void cross(const double u[3], const double v[3], double w[3]) {
+  w[0] = u[1]*v[2] - u[2]*v[1];
+  w[1] = u[2]*v[0] - u[0]*v[2];
+  w[2] = u[0]*v[1] - u[1]*v[0];
+}
+
+static double dot(const double u[3], const double v[3]) {
+  return u[0]*v[0] + u[1]*v[1] + u[2]*v[2];
+}
+
+/* scale u to length 1; returns 0 if it is too short to have a direction */
+static int normalize(double u[3]) {
+  double len = sqrt(dot(u, u));
+  if (len < 1e-300) return 0;
+  for (int i = 0; i < 3; i++) u[i] /= len;
+  return 1;
+}
+
+
+/* eigenvectors of the symmetric matrix a, by cyclic Jacobi rotations.
+   the columns of v are the eigenvectors */
+static void jacobi_eigen(double a[3][3], double v[3][3]) {
+
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) v[i][j] = (i == j);
+
+  for (int sweep = 0; sweep < 50; sweep++) {
+    double off = a[0][1]*a[0][1] + a[0][2]*a[0][2] + a[1][2]*a[1][2];
+    double diag = a[0][0]*a[0][0] + a[1][1]*a[1][1] + a[2][2]*a[2][2];
+    if (off <= 1e-30 * diag) break;
+
+    for (int p = 0; p < 2; p++) {
+      for (int q = p+1; q < 3; q++) {
+        if (a[p][q] == 0) continue;
+        double theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+        double t = (theta >= 0 ? 1 : -1) / (fabs(theta) + sqrt(theta*theta + 1));
+        double c = 1 / sqrt(t*t + 1), s = t * c;
+        for (int k = 0; k < 3; k++) {
+          double akp = a[k][p], akq = a[k][q];
+          a[k][p] = c*akp - s*akq;
+          a[k][q] = s*akp + c*akq;
+        }
+        for (int k = 0; k < 3; k++) {
+          double apk = a[p][k], aqk = a[q][k];
+          a[p][k] = c*apk - s*aqk;
+          a[q][k] = s*apk + c*aqk;
+        }
+        for (int k = 0; k < 3; k++) {
+          double vkp = v[k][p], vkq = v[k][q];
+          v[k][p] = c*vkp - s*vkq;
+          v[k][q] = s*vkp + c*vkq;
+        }
+      }
+    }
+  }
+}
+
+
+/* fill in center and volume of a box whose axes and extents along
+   them, [lo[i], hi[i]], are known */
+static void finish_box(obb *box, const double lo[3], const double hi[3], const double origin[3]) {
+
+  box->volume = 1;
+  for (int i = 0; i < 3; i++) {
+    box->half[i] = (hi[i] - lo[i]) / 2;
+    box->volume *= hi[i] - lo[i];
+  }
+  for (int k = 0; k < 3; k++) {
+    box->center[k] = origin[k];
+    for (int i = 0; i < 3; i++) box->center[k] += box->axis[i][k] * (lo[i] + hi[i]) / 2;
+  }
+}
+
+
+/* the principal axes of the solid hull, as a right handed frame */
+static void principal_axes(hull_metrics *m, double axis[3][3]) {
+
+  //the covariance of the solid is trace(I)/2 - I
+  double cov[3][3], v[3][3];
+  double trace = m->inertia[0][0] + m->inertia[1][1] + m->inertia[2][2];
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++) cov[i][j] = (i == j ? trace / 2 : 0) - m->inertia[i][j];
+  jacobi_eigen(cov, v);
+
+  for (int i = 0; i < 3; i++)
+    for (int k = 0; k < 3; k++) axis[i][k] = v[k][i];
+  cross(axis[0], axis[1], axis[2]);
+}
+
+
+void obb_pca(vector<point3d> &points, hull_mesh *mesh, hull_metrics *m, obb *box) {
+
+  memset(box, 0, sizeof(obb));
+  if (mesh->vert.size() == 0) return;
+  principal_axes(m, box->axis);
+
+  //extents from the support vertices in +-axis, measured from the
+  //first hull vertex to keep the numbers small
+  point3d &o = points[mesh->vert[0]];
+  double origin[3] = {(double)o.x, (double)o.y, (double)o.z};
+  double lo[3], hi[3];
+  for (int i = 0; i < 3; i++) {
+    double neg[3] = {-box->axis[i][0], -box->axis[i][1], -box->axis[i][2]};
+    point3d &p = points[mesh->vert[hull_support(points, mesh, box->axis[i], 0)]];
+    point3d &q = points[mesh->vert[hull_support(points, mesh, neg, 0)]];
+    double dp[3] = {p.x - origin[0], p.y - origin[1], p.z - origin[2]};
+    double dq[3] = {q.x - origin[0], q.y - origin[1], q.z - origin[2]};
+    hi[i] = dot(box->axis[i], dp);
+    lo[i] = dot(box->axis[i], dq);
+  }
+  finish_box(box, lo, hi, origin);
+}
+
+
+
+/* a 2d point of the projected hull */
+typedef struct _pt2 {
+  double x, y;
+  int id;      //the hull vertex it is the projection of
+} pt2;
+
+static bool pt2_less(const pt2 &a, const pt2 &b) {
+  return a.x < b.x || (a.x == b.x && a.y < b.y);
+}
+
+static double cross2(pt2 o, pt2 a, pt2 b) {
+  return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+/* counterclockwise 2d hull of pts (Andrew's monotone chain), without
+   collinear points */
+static void hull2d(vector<pt2> &pts, vector<pt2> &h) {
+
+  sort(pts.begin(), pts.end(), pt2_less);
+  h.resize(2 * pts.size());
+  int k = 0;
+  for (size_t i = 0; i < pts.size(); i++) {
+    while (k >= 2 && cross2(h[k-2], h[k-1], pts[i]) <= 0) k--;
+    h[k++] = pts[i];
+  }
+  for (int i = (int)pts.size() - 2, t = k + 1; i >= 0; i--) {
+    while (k >= t && cross2(h[k-2], h[k-1], pts[i]) <= 0) k--;
+    h[k++] = pts[i];
+  }
+  h.resize(max(k - 1, 1));
+}
+
+
+/* the hull vertices (indices into mesh->vert) that a box around an
+   axis u touches: the supports along u, the hull edge ab one side of
+   the rectangle is flush with, and the extreme vertices along and
+   across that edge. all -1 but top and bottom if the hull projects to
+   a segment or a point */
+typedef struct _box_contacts {
+  int top, bottom;
+  int a, b;
+  int right, left, far;
+} box_contacts;
+
+
+/* the smallest box with u as one of its axes: the extent along u is
+   read off the projections, the other two axes come from the minimum
+   area rectangle around the projected hull (rotating calipers). if c
+   is not NULL the vertices the box touches are stored there */
+static void box_around_axis(vector<point3d> &points, hull_mesh *mesh, const double u[3],
+                            vector<pt2> &pts, vector<pt2> &h, obb *box, box_contacts *c) {
+
+  //a frame u, p, q
+  double e[3] = {0, 0, 0}, p[3], q[3];
+  int k = 0;
+  if (fabs(u[1]) < fabs(u[k])) k = 1;
+  if (fabs(u[2]) < fabs(u[k])) k = 2;
+  e[k] = 1;
+  cross(u, e, p);
+  normalize(p);
+  cross(u, p, q);
+
+  point3d &o = points[mesh->vert[0]];
+  double origin[3] = {(double)o.x, (double)o.y, (double)o.z};
+  double lo[3], hi[3];
+  lo[0] = DBL_MAX;
+  hi[0] = -DBL_MAX;
+  int top = 0, bottom = 0;
+  pts.resize(mesh->vert.size());
+  for (size_t i = 0; i < mesh->vert.size(); i++) {
+    point3d &v = points[mesh->vert[i]];
+    double d[3] = {v.x - origin[0], v.y - origin[1], v.z - origin[2]};
+    double s = dot(u, d);
+    if (s < lo[0]) {
+      lo[0] = s;
+      bottom = i;
+    }
+    if (s > hi[0]) {
+      hi[0] = s;
+      top = i;
+    }
+    pts[i].x = dot(p, d);
+    pts[i].y = dot(q, d);
+    pts[i].id = i;
+  }
+  hull2d(pts, h);
+  int m = h.size();
+
+  //rotating calipers: one side of the rectangle on each hull edge in
+  //turn, with pointers to the extreme points along and across it
+  double best = DBL_MAX, dir[2] = {1, 0}, ext[4] = {0, 0, 0, 0};
+  int r = 0, t = 0, l = 0, edge = -1, right = 0, left = 0, far = 0;
+  for (int i = 0; i < m && m >= 3; i++) {
+    pt2 a = h[i], b = h[(i+1) % m];
+    double dx = b.x - a.x, dy = b.y - a.y, len = sqrt(dx*dx + dy*dy);
+    if (len == 0) continue;
+    dx /= len;
+    dy /= len;
+    //projections along the edge (dx,dy) and along its inward normal (-dy,dx)
+    #define ALONG(j) (h[(j) % m].x * dx + h[(j) % m].y * dy)
+    #define ACROSS(j) (-(h[(j) % m].x - a.x) * dy + (h[(j) % m].y - a.y) * dx)
+    if (i == 0) {
+      r = t = l = 0;
+    }
+    for (int s = 0; s < m && ALONG(r + 1) >= ALONG(r); s++) r = (r + 1) % m;
+    if (i == 0) t = r;
+    for (int s = 0; s < m && ACROSS(t + 1) >= ACROSS(t); s++) t = (t + 1) % m;
+    if (i == 0) l = t;
+    for (int s = 0; s < m && ALONG(l + 1) <= ALONG(l); s++) l = (l + 1) % m;
+    double width = ALONG(r) - ALONG(l), height = ACROSS(t);
+    if (width * height < best) {
+      best = width * height;
+      dir[0] = dx;
+      dir[1] = dy;
+      ext[0] = ALONG(l);
+      ext[1] = ALONG(r);
+      ext[2] = a.x * -dy + a.y * dx;
+      ext[3] = ext[2] + height;
+      edge = i;
+      right = r;
+      left = l;
+      far = t;
+    }
+    #undef ALONG
+    #undef ACROSS
+  }
+  if (m < 3) {
+    //the hull projects to a segment or a point
+    best = 0;
+    edge = -1;
+  }
+  if (c) {
+    c->top = top;
+    c->bottom = bottom;
+    c->a = c->b = c->right = c->left = c->far = -1;
+    if (edge >= 0) {
+      c->a = h[edge].id;
+      c->b = h[(edge+1) % m].id;
+      c->right = h[right].id;
+      c->left = h[left].id;
+      c->far = h[far].id;
+    }
+  }
+
+  for (int k = 0; k < 3; k++) {
+    box->axis[0][k] = u[k];
+    box->axis[1][k] = p[k] * dir[0] + q[k] * dir[1];
+  }
+  cross(box->axis[0], box->axis[1], box->axis[2]);
+  lo[1] = ext[0];
+  hi[1] = ext[1];
+  lo[2] = ext[2];
+  hi[2] = ext[3];
+  finish_box(box, lo, hi, origin);
+}
+
+
+/* the best box over the candidate axes dirs[from..to) */
+static void best_box(vector<point3d> *points, hull_mesh *mesh, vector<double> *dirs,
+                     size_t from, size_t to, obb *best) {
+
+  vector<pt2> pts, h;
+  best->volume = DBL_MAX;
+  for (size_t i = from; i < to; i++) {
+    obb box;
+    box_around_axis(*points, mesh, &(*dirs)[3*i], pts, h, &box, NULL);
+    if (box.volume < best->volume) *best = box;
+  }
+}
+
+
+/* the candidate axes every search starts from: the face normals and,
+   if m is not NULL, the principal axes. the arcs of the edges that are
+   not flat go to arcs, as the normals of their two faces */
+static void face_axes(vector<point3d> &points, hull_mesh *mesh, hull_metrics *m,
+                      vector<double> &dirs, vector<double> &arcs) {
+
+  size_t nf = mesh->face.size() / 3;
+  dirs.resize(3 * nf);
+  for (size_t f = 0; f < nf; f++) {
+    point3d &a = points[mesh->vert[mesh->face[3*f]]];
+    point3d &b = points[mesh->vert[mesh->face[3*f+1]]];
+    point3d &c = points[mesh->vert[mesh->face[3*f+2]]];
+    double u[3] = {(double)b.x - a.x, (double)b.y - a.y, (double)b.z - a.z};
+    double v[3] = {(double)c.x - a.x, (double)c.y - a.y, (double)c.z - a.z};
+    cross(u, v, &dirs[3*f]);
+    normalize(&dirs[3*f]);
+  }
+
+  arcs.clear();
+  for (size_t e = 0; e < mesh->nbr.size(); e++) {
+    int f = e / 3, g = mesh->nbr[e];
+    if (g < f) continue;   //each edge once, and skip open edges
+    double *n1 = &dirs[3*f], *n2 = &dirs[3*g];
+    //flat edges, and the folds of a hull with no volume
+    if (fabs(dot(n1, n2)) > 1 - 1e-12) continue;
+    arcs.insert(arcs.end(), n1, n1 + 3);
+    arcs.insert(arcs.end(), n2, n2 + 3);
+  }
+
+  if (m) {
+    double axis[3][3];
+    principal_axes(m, axis);
+    for (int i = 0; i < 3; i++) dirs.insert(dirs.end(), axis[i], axis[i] + 3);
+  }
+}
+
+
+void obb_sampled(vector<point3d> &points, hull_mesh *mesh, hull_metrics *m, int samples,
+                 obb *box, int nthreads) {
+
+  memset(box, 0, sizeof(obb));
+  if (mesh->vert.size() == 0) return;
+  if (nthreads <= 0) nthreads = thread::hardware_concurrency();
+  if (nthreads <= 0) nthreads = 1;
+
+  //candidate axes: every face normal, the principal axes, and samples
+  //on the arc between the normals of the two faces of every edge
+  vector<double> dirs, arcs;
+  face_axes(points, mesh, m, dirs, arcs);
+  for (size_t e = 0; e < arcs.size(); e += 6) {
+    double *n1 = &arcs[e], *n2 = &arcs[e+3];
+    for (int s = 1; s <= samples; s++) {
+      double t = (double)s / (samples + 1), d[3];
+      for (int k = 0; k < 3; k++) d[k] = (1 - t) * n1[k] + t * n2[k];
+      if (!normalize(d)) continue;
+      dirs.insert(dirs.end(), d, d + 3);
+    }
+  }
+
+  size_t nd = dirs.size() / 3;
+  if (nd < 4 * (size_t)nthreads) nthreads = 1;
+  vector<obb> part(nthreads);
+  size_t chunk = (nd + nthreads - 1) / nthreads;
+  vector<thread> workers;
+  for (int t = 0; t < nthreads; t++) {
+    size_t from = min(nd, t * chunk), to = min(nd, from + chunk);
+    workers.push_back(thread(best_box, &points, mesh, &dirs, from, to, &part[t]));
+  }
+  for (int t = 0; t < nthreads; t++) workers[t].join();
+  *box = part[0];
+  for (int t = 1; t < nthreads; t++) {
+    if (part[t].volume < box->volume) *box = part[t];
+  }
+}
+
+
+
+//evenly spaced angles an arc is first cut at, the samples that bracket
+//the stationary points of a piece, and how finely the angles are found
+#define ARC_STEPS 8
+#define ARC_SAMPLES 6
+#define ARC_EPS 1e-9
+#define ARC_DEPTH 64
+
+/* the volume of the box around u that touches the hull at c, for as
+   long as these are the vertices it touches: the height between the
+   supports along u times the rectangle on the edge ab, projected along
+   u. a smooth function of u */
+static double contact_volume(vector<point3d> &points, hull_mesh *mesh, const double u[3],
+                             box_contacts *c) {
+
+  if (c->a < 0) return 0;
+  //top - bottom, b - a, right - left and far - a
+  int from[4] = {c->bottom, c->a, c->left, c->a}, to[4] = {c->top, c->b, c->right, c->far};
+  double d[4][3];
+  for (int j = 0; j < 4; j++) {
+    point3d &p = points[mesh->vert[from[j]]], &q = points[mesh->vert[to[j]]];
+    d[j][0] = (double)q.x - p.x;
+    d[j][1] = (double)q.y - p.y;
+    d[j][2] = (double)q.z - p.z;
+  }
+  //the edge ab projected along u is the second axis, the third is
+  //normal to both
+  double s = dot(u, d[1]), g[3];
+  for (int k = 0; k < 3; k++) d[1][k] -= s * u[k];
+  if (!normalize(d[1])) return DBL_MAX;
+  cross(u, d[1], g);
+  return dot(u, d[0]) * dot(d[1], d[2]) * fabs(dot(g, d[3]));
+}
+
+
+/* the search along one arc: the normals of the planes through a hull
+   edge that support the hull are cos(t) n + sin(t) w, for t from 0 to
+   angle */
+typedef struct _arc_search {
+  vector<point3d> *points;
+  hull_mesh *mesh;
+  double n[3], w[3], angle;
+  vector<pt2> pts, h;
+  obb *best;
+} arc_search;
+
+static void arc_axis(arc_search *s, double t, double u[3]) {
+  for (int k = 0; k < 3; k++) u[k] = cos(t) * s->n[k] + sin(t) * s->w[k];
+}
+
+/* the box around the axis at t, kept if it is the smallest so far, and
+   the vertices it touches */
+static void arc_box(arc_search *s, double t, box_contacts *c) {
+  double u[3];
+  obb box;
+  arc_axis(s, t, u);
+  box_around_axis(*s->points, s->mesh, u, s->pts, s->h, &box, c);
+  if (box.volume < s->best->volume) *s->best = box;
+}
+
+static double arc_volume(arc_search *s, double t, box_contacts *c) {
+  double u[3];
+  arc_axis(s, t, u);
+  return contact_volume(*s->points, s->mesh, u, c);
+}
+
+/* whether c0 and c1 give the same volume between t0 and t1. they are
+   often different vertices at the same place: the two ends of the edge
+   of the arc, say, are both supports along every axis on it */
+static int same_contacts(arc_search *s, box_contacts *c0, box_contacts *c1, double t0,
+                         double t1) {
+
+  if (memcmp(c0, c1, sizeof(box_contacts)) == 0) return 1;
+  double t[3] = {t0, (t0 + t1) / 2, t1};
+  for (int i = 0; i < 3; i++) {
+    double v0 = arc_volume(s, t[i], c0), v1 = arc_volume(s, t[i], c1);
+    if (fabs(v0 - v1) > 1e-12 * max(fabs(v0), fabs(v1))) return 0;
+  }
+  return 1;
+}
+
+/* a minimum of the volume of the boxes touching c for t in [lo, hi],
+   by golden section */
+static double arc_minimum(arc_search *s, box_contacts *c, double lo, double hi) {
+
+  const double r = (sqrt(5.0) - 1) / 2;
+  double x1 = hi - r * (hi - lo), x2 = lo + r * (hi - lo);
+  double f1 = arc_volume(s, x1, c), f2 = arc_volume(s, x2, c);
+  while (hi - lo > ARC_EPS) {
+    if (f1 <= f2) {
+      hi = x2;
+      x2 = x1;
+      f2 = f1;
+      x1 = hi - r * (hi - lo);
+      f1 = arc_volume(s, x1, c);
+    } else {
+      lo = x1;
+      x1 = x2;
+      f1 = f2;
+      x2 = lo + r * (hi - lo);
+      f2 = arc_volume(s, x2, c);
+    }
+  }
+  return (lo + hi) / 2;
+}
+
+/* the smallest box with an axis on the arc between t0 and t1, where
+   the boxes touch c0 and c1; both ends have been tried */
+static void arc_interval(arc_search *s, double t0, double t1, box_contacts *c0,
+                         box_contacts *c1, int depth) {
+
+  if (t1 - t0 < ARC_EPS || depth > ARC_DEPTH) return;
+  box_contacts c;
+  if (!same_contacts(s, c0, c1, t0, t1)) {
+    //the contacts change in between: halve until the change is pinned down
+    double t = (t0 + t1) / 2;
+    arc_box(s, t, &c);
+    arc_interval(s, t0, t, c0, &c, depth + 1);
+    arc_interval(s, t, t1, &c, c1, depth + 1);
+    return;
+  }
+
+  //one set of contacts: the volume is smooth in t and its minimum is at
+  //an end or at a stationary point, bracketed by the samples that are
+  //no larger than their neighbours
+  double step = (t1 - t0) / ARC_SAMPLES, v[ARC_SAMPLES+1];
+  for (int i = 0; i <= ARC_SAMPLES; i++) v[i] = arc_volume(s, t0 + i * step, c0);
+  for (int i = 1; i < ARC_SAMPLES; i++) {
+    if (v[i] > v[i-1] || v[i] > v[i+1]) continue;
+    double t = arc_minimum(s, c0, t0 + (i - 1) * step, t0 + (i + 1) * step);
+    arc_box(s, t, &c);
+    //the contacts changed and changed back in between: search both sides
+    if (!same_contacts(s, c0, &c, t0, t1)) {
+      arc_interval(s, t0, t, c0, &c, depth + 1);
+      arc_interval(s, t, t1, &c, c1, depth + 1);
+      return;
+    }
+  }
+}
+
+
+/* the smallest box with an axis on one of the arcs [from, to) */
+static void best_on_arcs(vector<point3d> *points, hull_mesh *mesh, vector<double> *arcs,
+                         size_t from, size_t to, obb *best) {
+
+  arc_search s;
+  s.points = points;
+  s.mesh = mesh;
+  s.best = best;
+  best->volume = DBL_MAX;
+  for (size_t i = from; i < to; i++) {
+    double *n1 = &(*arcs)[6*i], *n2 = n1 + 3, cosine = max(-1.0, min(1.0, dot(n1, n2)));
+    for (int k = 0; k < 3; k++) {
+      s.n[k] = n1[k];
+      s.w[k] = n2[k] - cosine * n1[k];
+    }
+    if (!normalize(s.w)) continue;
+    s.angle = acos(cosine);
+
+    box_contacts c[ARC_STEPS+1];
+    for (int j = 0; j <= ARC_STEPS; j++) arc_box(&s, s.angle * j / ARC_STEPS, &c[j]);
+    for (int j = 0; j < ARC_STEPS; j++) {
+      arc_interval(&s, s.angle * j / ARC_STEPS, s.angle * (j + 1) / ARC_STEPS, &c[j], &c[j+1], 0);
+    }
+  }
+}
+
+
+void obb_exact(vector<point3d> &points, hull_mesh *mesh, hull_metrics *m, obb *box,
+               int nthreads) {
+
+  memset(box, 0, sizeof(obb));
+  if (mesh->vert.size() == 0) return;
+  if (nthreads <= 0) nthreads = thread::hardware_concurrency();
+  if (nthreads <= 0) nthreads = 1;
+
+  //the face normals and principal axes, then every point of every arc
+  vector<double> dirs, arcs;
+  face_axes(points, mesh, m, dirs, arcs);
+  best_box(&points, mesh, &dirs, 0, dirs.size() / 3, box);
+
+  size_t na = arcs.size() / 6;
+  if (na < 4 * (size_t)nthreads) nthreads = 1;
+  vector<obb> part(nthreads);
+  size_t chunk = (na + nthreads - 1) / nthreads;
+  vector<thread> workers;
+  for (int t = 0; t < nthreads; t++) {
+    size_t from = min(na, t * chunk), to = min(na, from + chunk);
+    workers.push_back(thread(best_on_arcs, &points, mesh, &arcs, from, to, &part[t]));
+  }
+  for (int t = 0; t < nthreads; t++) workers[t].join();
+  for (int t = 0; t < nthreads; t++) {
+    if (part[t].volume < box->volume) *box = part[t];
+  }
+}
+
+
+void print_obb(obb *box) {
+
+  printf("obb: volume %.1f, center (%.2f, %.2f, %.2f)\n", box->volume,
+         box->center[0], box->center[1], box->center[2]);
+  for (int i = 0; i < 3; i++) {
+    printf("  axis (%.4f, %.4f, %.4f) half %.2f\n", box->axis[i][0], box->axis[i][1],
+           box->axis[i][2], box->half[i]);
+  }
+}
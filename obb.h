@@ -0,0 +1,60 @@
+#ifndef __obb_h
+#define __obb_h
+
+#include "geom.h"
+#include "hullmesh.h"
+#include "hullmetrics.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* an oriented bounding box */
+typedef struct _obb {
+  double center[3];
+  double axis[3][3];   //orthonormal axes, axis[i] is the i-th one
+  double half[3];      //half extents along the axes
+  double volume;
+} obb;
+
+
+/* fast approximate box: the axes are the principal axes of the solid
+   hull, from the inertia tensor in m (which must be valid), and the
+   extents are found by walking the mesh to the 6 support vertices */
+void obb_pca(vector<point3d> &points, hull_mesh *mesh, hull_metrics *m, obb *box);
+
+/* approximate minimum volume box. by O'Rourke, two adjacent faces of
+   the optimal box are flush with edges of the hull, so one box axis
+   lies on the arc between the normals of the two faces of a hull edge.
+   each face normal and samples evenly spaced points of each such arc
+   are tried as an axis, and the two other axes are then found exactly
+   with rotating calipers on the hull projected along it. the result is
+   the optimal box only when that box has a face flush with a face of
+   the hull; otherwise it is within the sampling of the arcs. if m is
+   not NULL the principal axes are tried too, so the box is never
+   larger than obb_pca(). the candidate axes are split over nthreads
+   threads (0 means one per core) */
+void obb_sampled(vector<point3d> &points, hull_mesh *mesh, hull_metrics *m, int samples,
+                 obb *box, int nthreads);
+
+/* minimum volume box, by the same edge pair method without sampling.
+   along the arc of an edge the hull vertices that the box around the
+   axis touches change at finitely many angles, which are found by
+   bisection to within 1e-9 radians; in between the volume is a smooth
+   function of the angle whose minimum is at an end or a stationary
+   point, found by golden section search. each arc is first cut at 8
+   even angles, and the box at every minimum found is checked to touch
+   the vertices it was found for, so that vertices that change and
+   change back between two cuts are still followed. never larger than
+   obb_sampled() (up to rounding), but the hull is projected some
+   hundred times per edge. the arcs are split over nthreads threads (0
+   means one per core) */
+void obb_exact(vector<point3d> &points, hull_mesh *mesh, hull_metrics *m, obb *box,
+               int nthreads);
+
+void print_obb(obb *box);
+
+#endif
@@ -0,0 +1,408 @@
+/*  pointgen.cpp
+ *
+ *  point sets for the viewer, the checks and benchmarks, without GL.
+ *
+ *  the random numbers come from Philox4x32-10, keyed by the seed, with
+ *  the point index (and a block number, for points that need more than
+ *  4 words) as the counter. there is no state carried from one point to
+ *  the next, so the points can be made in any order, by any number of
+ *  threads, and always come out the same.
+ *
+ */
+
+
+#include "pointgen.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+
+//below this many points the threads cost more than they save
+const long PARALLEL_POINTS = 10000;
+
+
+void philox(const unsigned int counter[4], const unsigned int key[2], unsigned int out[4]) {
+
+  unsigned int c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+  unsigned int k0 = key[0], k1 = key[1];
+  for (int round = 0; round < 10; round++) {
+    unsigned long long p0 = 0xD2511F53ULL * c0, p1 = 0xCD9E8D57ULL * c2;
+    unsigned int n0 = (unsigned int)(p1 >> 32) ^ c1 ^ k0;
+    unsigned int n2 = (unsigned int)(p0 >> 32) ^ c3 ^ k1;
+    c1 = (unsigned int)p1;
+    c3 = (unsigned int)p0;
+    c0 = n0;
+    c2 = n2;
+    k0 += 0x9E3779B9;
+    k1 += 0xBB67AE85;
+  }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+
+/* 4 random words for block b of point i */
+static void words(const gen_params *g, long i, unsigned int b, unsigned int w[4]) {
+  unsigned int counter[4] = {(unsigned int)i, (unsigned int)((unsigned long long)i >> 32), b, 0};
+  unsigned int key[2] = {(unsigned int)g->seed, (unsigned int)(g->seed >> 32)};
+  philox(counter, key, w);
+}
+
+/* a word as a double in (0, 1) */
+static double unit(unsigned int w) {
+  return (w + 0.5) / 4294967296.0;
+}
+
+static point3d make_point(double x, double y, double z) {
+  point3d p = {(int)floor(x + 0.5), (int)floor(y + 0.5), (int)floor(z + 0.5)};
+  return p;
+}
+
+static double radius_of(const gen_params *g) {
+  return (g->radius > 0) ? g->radius : 0.35 * g->box;
+}
+
+/* a point on the unit sphere, uniformly */
+static void direction(double u, double v, double d[3]) {
+  double z = 2*u - 1, r = sqrt(max(0.0, 1 - z*z)), phi = 2*M_PI*v;
+  d[0] = r * cos(phi);
+  d[1] = r * sin(phi);
+  d[2] = z;
+}
+
+
+/* ****************************** */
+/* the viewer's test cases. they keep the shapes they had when they
+   were written into the global points of hull3d.cpp with random() */
+
+/* uniform in the middle 70% of the box */
+static point3d gen_random(const gen_params *g, long i) {
+  unsigned int w[4];
+  words(g, i, 0, w);
+  int lo = (int)(.3*g->box)/2, range = (int)(.7*g->box);
+  point3d p = {lo + (int)(w[0] % range), lo + (int)(w[1] % range), lo + (int)(w[2] % range)};
+  return p;
+}
+
+/* Jack's spiral/spring */
+static point3d gen_spring(const gen_params *g, long i) {
+  float step = g->box / g->n;
+  point3d p;
+  p.x = (int)(g->box * ((cos(i * step) + 1) * .5));
+  p.y = (int)(g->box * ((sin(i * step) + 1) * .5));
+  p.z = (int)(i * step);
+  return p;
+}
+
+static point3d gen_droplet(const gen_params *g, long i) {
+  unsigned int w[4];
+  words(g, i, 0, w);
+  int offset = 200, scaleX = 120, scaleY = 250, scaleZ = 520;
+  point3d p;
+  p.x = (int)scaleX*(1 - sin(i)) * cos(i) + offset;
+  p.y = (int)scaleY*(sin(1-i)) + offset;
+  p.z = -(int)(w[0] % scaleZ);
+  return p;
+}
+
+static point3d gen_heart(const gen_params *g, long i) {
+  unsigned int w[4];
+  words(g, i, 0, w);
+  float R = 100;
+  point3d p;
+  p.x = R*4.f*pow(sin(i),3.f);
+  p.y = R*0.25f*(13*cos(i)-5*cos(2.f*i)-2.f*cos(3.f*i)-cos(4.f*i));
+  p.z = w[0] % 200;
+  return p;
+}
+
+/* two rows of 5 points */
+static point3d gen_house(const gen_params *g, long j) {
+  int i = j + 1, ymult = 1;
+  if (i > 5) {
+    i = i - 5;
+    ymult = 2;
+  }
+  point3d p;
+  p.y = 125*ymult;
+  if (i < 3) {
+    p.x = 125;
+    p.z = 125*i;
+  } else if (i == 3) {
+    p.x = 250;
+    p.z = 375;
+  } else {
+    p.x = 375;
+    p.z = 125*(i-3);
+  }
+  return p;
+}
+
+/* vertical lines of 5 points at random places; Ryan St. Pierre */
+static point3d gen_vertlines(const gen_params *g, long i) {
+  unsigned int line[4], w[4];
+  words(g, i / 5, 1, line);
+  words(g, i, 0, w);
+  int lo = (int)(.3*g->box)/2, range = (int)(.7*g->box);
+  point3d p = {lo + (int)(line[0] % range), lo + (int)(line[1] % range), lo + (int)(w[0] % range)};
+  return p;
+}
+
+/* 9 spheres of 36 points; point i is point i%36 of sphere i/36 */
+static point3d gen_sphere_of_spheres(const gen_params *g, long i) {
+  int NR = 2, NPhi = 3, NTheta = 3;
+  float rMax = 200.0, dr = rMax / NR;
+  float dphi = 2*M_PI/NPhi, dtheta = M_PI/NTheta;
+  int s = i / 36, ti = s / NPhi, pj = s % NPhi, k = 1;
+  float x = g->box/2 + (dr * k) * sin(dtheta * ti)*cos(dphi * pj);
+  float y = g->box/2 + (dr * k) * sin(dtheta * ti)*sin(dphi * pj);
+  float z = g->box/2 + (dr * k) * cos(dtheta * ti);
+
+  int N = 6, a = (i % 36) / N, b = i % N;
+  float u = 2*M_PI/N, v = M_PI/N;
+  point3d p;
+  p.x = x + rMax * cos(u * a) * sin(v * b);
+  p.y = y + rMax * sin(u * a) * sin(v * b);
+  p.z = z + rMax * cos(b * v);
+  return p;
+}
+
+static point3d gen_personal(const gen_params *g, long i) {
+  float rad = 400, u = 2*M_PI/g->n, v = 2*M_PI/g->n;
+  point3d p;
+  p.x = rad * cos(6*i*u) * sin(i*v) + 330;
+  p.y = rad * sin(3*i*u) * sin(i*v) + 50;
+  p.z = rad * cos(i*v);
+  return p;
+}
+
+/* two crossing squares, half of the points on each */
+static point3d gen_cross(const gen_params *g, long i) {
+  unsigned int w[4];
+  words(g, i, 0, w);
+  int range = (int)(.5*g->box);
+  point3d p;
+  if (i < g->n/2) {
+    p.x = (int)(.3*g->box)/2 + w[0] % range;
+    p.y = (int)(.3*g->box)/2 + w[1] % range;
+    p.z = 250;
+  } else {
+    p.x = (int)(.5*g->box)/2 + w[0] % range;
+    p.y = 250;
+    p.z = (int)(.5*g->box)/2 + w[1] % range;
+  }
+  return p;
+}
+
+/* the 5 corners of a pyramid, and random points in a box inside it */
+static point3d gen_pyramid(const gen_params *g, long i) {
+  float maxZ = g->box, minZ = g->box/5, midZ = (maxZ - minZ)/2;
+  float maxX = g->box, minX = g->box/5, midX = (maxX + minX)/2;
+  float maxY = g->box, minY = g->box/5, midY = (maxY + minY)/2;
+  float corner[5][3] = {{maxX, minY, minZ}, {maxX, maxY, minZ}, {minX, minY, minZ},
+                        {minX, maxY, minZ}, {midX, midY, maxZ}};
+  point3d p;
+  if (i < 5) {
+    p.x = corner[i][0];
+    p.y = corner[i][1];
+    p.z = corner[i][2];
+    return p;
+  }
+  unsigned int w[4];
+  words(g, i, 0, w);
+  p.x = (midX+minX)/2 + ((maxX - minX)/2) * (float)unit(w[0]);
+  p.y = (midY+minY)/2 + ((maxY - minY)/2) * (float)unit(w[1]);
+  p.z = minZ + midZ * (float)unit(w[2]);
+  return p;
+}
+
+/* an octahedron with all the other points at its center */
+static point3d gen_diamond(const gen_params *g, long i) {
+  int corner[7][3] = {{0, 200, 0}, {0, 100, 0}, {50, 150, 50}, {-50, 150, 50},
+                      {50, 150, -50}, {-50, 150, -50}, {0, 150, 0}};
+  int k = min(i, 6L);
+  point3d p = {corner[k][0], corner[k][1], corner[k][2]};
+  return p;
+}
+
+
+/* ****************************** */
+/* scalable sets, centered in the box */
+
+/* uniform in a ball: most points are inside, the hull has O(n^1/3)
+   vertices */
+static point3d gen_ball(const gen_params *g, long i) {
+  unsigned int w[4];
+  words(g, i, 0, w);
+  double d[3], r = radius_of(g) * cbrt(unit(w[2])), c = g->box / 2.0;
+  direction(unit(w[0]), unit(w[1]), d);
+  return make_point(c + r*d[0], c + r*d[1], c + r*d[2]);
+}
+
+/* uniform on a sphere: almost every point is a hull vertex */
+static point3d gen_sphere(const gen_params *g, long i) {
+  unsigned int w[4];
+  words(g, i, 0, w);
+  double d[3], r = radius_of(g), c = g->box / 2.0;
+  direction(unit(w[0]), unit(w[1]), d);
+  return make_point(c + r*d[0], c + r*d[1], c + r*d[2]);
+}
+
+/* gaussian clusters around centers spread in the ball. point i is in
+   cluster i % clusters */
+static point3d gen_clusters(const gen_params *g, long i) {
+  int nc = (g->clusters > 0) ? g->clusters : 8;
+  double r = radius_of(g), c = g->box / 2.0, sigma = r / (4 * cbrt((double)nc));
+
+  //the center, from the cluster number in its own block
+  unsigned int w[4];
+  words(g, i % nc, 2, w);
+  double d[3], rc = 0.7 * r * cbrt(unit(w[2]));
+  direction(unit(w[0]), unit(w[1]), d);
+  double center[3] = {c + rc*d[0], c + rc*d[1], c + rc*d[2]};
+
+  //three normal deviates (Box-Muller)
+  words(g, i, 0, w);
+  double m0 = sqrt(-2 * log(unit(w[0]))), m1 = sqrt(-2 * log(unit(w[2])));
+  double a0 = 2*M_PI*unit(w[1]), a1 = 2*M_PI*unit(w[3]);
+  return make_point(center[0] + sigma * m0 * cos(a0), center[1] + sigma * m0 * sin(a0),
+                    center[2] + sigma * m1 * cos(a1));
+}
+
+/* points on the surfaces of 13 equal spheres: one in the middle and
+   the 12 around it that touch it (the kissing configuration, centers on
+   an icosahedron). the outer points are all nearly on the hull and
+   nearly cospherical, a hard case for the engines */
+static point3d gen_kissing(const gen_params *g, long i) {
+  //the icosahedron (0, +-1, +-phi) and its cyclic shifts, normalized
+  const double a = 0.5257311121191336, b = 0.8506508083520400;
+  static const double ico[12][3] = {
+    {0, a, b}, {a, b, 0}, {b, 0, a}, {0, -a, b}, {-a, b, 0}, {b, 0, -a},
+    {0, a, -b}, {a, -b, 0}, {-b, 0, a}, {0, -a, -b}, {-a, -b, 0}, {-b, 0, -a}
+  };
+
+  double rs = radius_of(g) / 3, c = g->box / 2.0;
+  double center[3] = {c, c, c};
+  int s = i % 13;
+  if (s > 0) {
+    for (int t = 0; t < 3; t++) center[t] += 2 * rs * ico[s-1][t];
+  }
+  unsigned int w[4];
+  words(g, i, 0, w);
+  double d[3];
+  direction(unit(w[0]), unit(w[1]), d);
+  return make_point(center[0] + rs*d[0], center[1] + rs*d[1], center[2] + rs*d[2]);
+}
+
+
+static long size_house(long n) { return 10; }
+static long size_vertlines(long n) { return n / 5 * 5; }
+static long size_sphere_of_spheres(long n) { return 9 * 36; }
+static long size_cross(long n) { return n / 2 * 2; }
+static long size_pyramid(long n) { return max(n, 5L); }
+static long size_diamond(long n) { return max(n, 6L); }
+
+point_generator_entry point_generators[] = {
+  {"random", gen_random, NULL},
+  {"pyramid", gen_pyramid, size_pyramid},
+  {"cross", gen_cross, size_cross},
+  {"diamond", gen_diamond, size_diamond},
+  {"spring", gen_spring, NULL},
+  {"sphereOfSpheres", gen_sphere_of_spheres, size_sphere_of_spheres},
+  {"vertlines", gen_vertlines, size_vertlines},
+  {"heart", gen_heart, NULL},
+  {"droplet", gen_droplet, NULL},
+  {"house", gen_house, size_house},
+  {"personal", gen_personal, NULL},
+  {"ball", gen_ball, NULL},
+  {"sphere", gen_sphere, NULL},
+  {"clusters", gen_clusters, NULL},
+  {"kissing", gen_kissing, NULL},
+  {NULL, NULL, NULL}
+};
+
+
+const point_generator_entry *find_generator(const char *name) {
+
+  for (int k = 0; point_generators[k].name; k++) {
+    if (strcmp(point_generators[k].name, name) == 0) return &point_generators[k];
+  }
+  return NULL;
+}
+
+
+/* points lo..hi-1 of a set, into the arrays or into points */
+static void fill_range(const point_generator_entry *e, const gen_params *g, long lo, long hi,
+                       point_soa *soa, point3d *points) {
+
+  for (long i = lo; i < hi; i++) {
+    point3d p = e->fn(g, i);
+    if (points) {
+      points[i] = p;
+    } else {
+      soa->x[i] = p.x;
+      soa->y[i] = p.y;
+      soa->z[i] = p.z;
+    }
+  }
+}
+
+static long generate(const char *name, const gen_params *g, point_soa *soa,
+                     vector<point3d> *points, int nthreads) {
+
+  const point_generator_entry *e = find_generator(name);
+  if (!e) return -1;
+  long n = e->size ? e->size(g->n) : g->n;
+  if (points) {
+    points->resize(n);
+  } else {
+    soa->x.resize(n);
+    soa->y.resize(n);
+    soa->z.resize(n);
+  }
+  point3d *out = points ? points->data() : NULL;
+
+  if (nthreads <= 0) nthreads = thread::hardware_concurrency();
+  if (nthreads <= 0 || n < PARALLEL_POINTS) nthreads = 1;
+  long chunk = (n + nthreads - 1) / nthreads;
+  if (nthreads == 1) {
+    fill_range(e, g, 0, n, soa, out);
+  } else {
+    vector<thread> workers;
+    for (int t = 0; t < nthreads; t++) {
+      long from = min(n, t * chunk), to = min(n, from + chunk);
+      workers.push_back(thread(fill_range, e, g, from, to, soa, out));
+    }
+    for (int t = 0; t < nthreads; t++) workers[t].join();
+  }
+  return n;
+}
+
+
+long generate_points(const char *name, const gen_params *g, vector<point3d> &points,
+                     int nthreads) {
+  return generate(name, g, NULL, &points, nthreads);
+}
+
+
+long generate_soa(const char *name, const gen_params *g, point_soa *out, int nthreads) {
+  return generate(name, g, out, NULL, nthreads);
+}
+
+
+void soa_to_points(point_soa *soa, vector<point3d> &points) {
+
+  points.resize(soa->x.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    points[i].x = soa->x[i];
+    points[i].y = soa->y[i];
+    points[i].z = soa->z[i];
+  }
+}
@@ -0,0 +1,63 @@
+#ifndef __pointgen_h
+#define __pointgen_h
+
+#include "geom.h"
+
+#include <vector>
+
+
+using namespace std;
+
+
+
+/* what to generate. every point is a function of (seed, its index)
+   only, so the same parameters always give the same points, whatever
+   the number of threads */
+typedef struct _gen_params {
+  long n;                   //points asked for (some sets have a fixed size)
+  unsigned long long seed;
+  int box;                  //the sets are laid out in [0, box]^3 (the viewer's WINDOWSIZE)
+  double radius;            //radius of the ball, sphere, clusters and kissing sets; 0 means 0.35 box
+  int clusters;             //number of gaussian clusters; 0 means 8
+} gen_params;
+
+/* the coordinates of the points in separate arrays */
+typedef struct _point_soa {
+  vector<int> x, y, z;
+} point_soa;
+
+
+/* point i of a set */
+typedef point3d (*point_generator)(const gen_params *g, long i);
+
+typedef struct _point_generator_entry {
+  const char *name;
+  point_generator fn;
+  long (*size)(long n);     //how many points the set has when n are asked for; NULL means n
+} point_generator_entry;
+
+/* the viewer's test cases, then the scalable sets (ball, sphere,
+   clusters, kissing), terminated by an entry with a NULL name */
+extern point_generator_entry point_generators[];
+
+/* the entry called name, or NULL */
+const point_generator_entry *find_generator(const char *name);
+
+
+/* fill points (or the arrays of out) with the set called name,
+   splitting the indices over nthreads threads (0 means one per core).
+   returns the number of points, or -1 if there is no such set */
+long generate_points(const char *name, const gen_params *g, vector<point3d> &points,
+                     int nthreads);
+long generate_soa(const char *name, const gen_params *g, point_soa *out, int nthreads);
+
+/* copy the arrays into points */
+void soa_to_points(point_soa *soa, vector<point3d> &points);
+
+
+/* Philox4x32-10: a counter based random number generator. the 4 words
+   of out depend only on the counter and the key; different counters
+   give independent streams */
+void philox(const unsigned int counter[4], const unsigned int key[2], unsigned int out[4]);
+
+#endif